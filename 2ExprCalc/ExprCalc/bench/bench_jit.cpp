@@ -0,0 +1,70 @@
+#include "../src/calculator.h"
+#include "../src/evaluator.h"
+#include "../src/jit.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+    using namespace exprcalc;
+
+    const char* const kExpression = "(a + 2.5) * b - a / (b + 1) + 3 * (c - a * b) / (c + 4)";
+
+    struct Fixture {
+        Calculator calc;
+        CompiledExpression compiled;
+        SymbolTable symbols;
+        double slots[3];
+
+        Fixture() : compiled(calc.compile(kExpression)), slots{} {
+            const auto& variables = compiled.bytecode().variables;
+            for (size_t i = 0; i < variables.size(); ++i) {
+                slots[i] = 1.0 + static_cast<double>(i);
+                symbols.set_variable(variables[i], slots[i]);
+                calc.set_variable(variables[i], slots[i]);
+            }
+        }
+    };
+
+    // 逐行调用：每次都重新词法分析、转逆波兰、编译
+    void BM_BackendCalculator(benchmark::State& state) {
+        Fixture fixture;
+        fixture.calc.set_cache_capacity(0);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(fixture.calc.evaluate(kExpression));
+        }
+    }
+    BENCHMARK(BM_BackendCalculator);
+
+    // Evaluator：字节码解释执行，变量按名字从 SymbolTable 中查找
+    void BM_BackendEvaluatorWithSymbolTable(benchmark::State& state) {
+        Fixture fixture;
+        for (auto _ : state) {
+            Evaluator evaluator(fixture.compiled.bytecode(), fixture.symbols);
+            benchmark::DoNotOptimize(evaluator.evaluate());
+        }
+    }
+    BENCHMARK(BM_BackendEvaluatorWithSymbolTable);
+
+    // 字节码解释器，变量槽位已解析好
+    void BM_BackendInterpreter(benchmark::State& state) {
+        Fixture fixture;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(Evaluator::execute(fixture.compiled.bytecode(), fixture.slots));
+        }
+    }
+    BENCHMARK(BM_BackendInterpreter);
+
+    void BM_BackendJit(benchmark::State& state) {
+        Fixture fixture;
+        auto jit = JitFunction::compile(fixture.compiled.bytecode());
+        if (!jit) {
+            state.SkipWithError("JIT not supported on this platform");
+            return;
+        }
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(jit->evaluate(fixture.slots));
+        }
+    }
+    BENCHMARK(BM_BackendJit);
+
+} // anonymous namespace
@@ -0,0 +1,281 @@
+#include "bench_support.h"
+#include "../src/ast.h"
+#include "../src/calculator.h"
+#include "../src/evaluator.h"
+#include "../src/expr_generator.h"
+#include "../src/lexer.h"
+#include "../src/pratt_parser.h"
+#include "../src/shunting_yard.h"
+#include "../src/streaming_parser.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace exprcalc;
+    using namespace exprcalc::bench;
+
+    void set_variables(Calculator& calc, SymbolTable& symbols, size_t variables) {
+        for (size_t i = 0; i < variables; ++i) {
+            double value = 1.0 + 0.1234567 * static_cast<double>(i);
+            calc.set_variable(variable_name(i), value);
+            symbols.set_variable(variable_name(i), value);
+        }
+    }
+
+    // 每次迭代处理一个表达式：ns/expr 即 Time 列；另外报告 tokens/s 和每次调用的内存分配次数
+    void report(benchmark::State& state, size_t tokens, size_t allocations_before) {
+        state.counters["tokens/s"] = benchmark::Counter(static_cast<double>(tokens),
+                                                        benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["allocs/expr"] = benchmark::Counter(
+            static_cast<double>(allocation_count() - allocations_before), benchmark::Counter::kAvgIterations);
+    }
+
+    size_t count_tokens(const std::string& expression) {
+        return Lexer(expression).tokenize().size();
+    }
+
+    // ---------- 各阶段，按表达式长度（操作数个数）参数化 ----------
+
+    void BM_LexerTokenize(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            Lexer lexer(expression);
+            benchmark::DoNotOptimize(lexer.tokenize());
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_LexerTokenize)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 只拉取标记不保存，参数为字符分类内核级别（0 标量 / 1 SSE2 / 2 AVX2），报告字节吞吐
+    void BM_LexerScan(benchmark::State& state) {
+        GeneratorOptions options;
+        options.terms = 2000;
+        options.paren_density = 0.3;
+        const std::string expression = ExpressionGenerator(options).next();
+        const auto level = static_cast<SimdLevel>(state.range(0));
+        for (auto _ : state) {
+            Lexer lexer(expression, level);
+            size_t tokens = 0;
+            while (lexer.next().type != TokenType::END) ++tokens;
+            benchmark::DoNotOptimize(tokens);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * expression.size()));
+        state.SetLabel(simd_level_name(std::min(level, detect_simd_level())));
+    }
+    BENCHMARK(BM_LexerScan)->DenseRange(0, 2);
+
+    void BM_ShuntingYardToRpn(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const auto tokens = Lexer(expression).tokenize();
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            ShuntingYard shunting_yard(tokens);
+            benchmark::DoNotOptimize(shunting_yard.to_rpn());
+        }
+        report(state, tokens.size(), allocations);
+    }
+    BENCHMARK(BM_ShuntingYardToRpn)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 与上面对比：直接建语法树再生成字节码，arena 在迭代之间复用
+    void BM_AstParseAndLower(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const auto tokens = Lexer(expression).tokenize();
+        Ast ast;
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            AstParser(tokens).parse(ast);
+            benchmark::DoNotOptimize(ast.to_bytecode());
+        }
+        report(state, tokens.size(), allocations);
+    }
+    BENCHMARK(BM_AstParseAndLower)->RangeMultiplier(8)->Range(8, 4096);
+
+    void BM_RpnCompile(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const auto tokens = Lexer(expression).tokenize();
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            ShuntingYard shunting_yard(tokens);
+            auto rpn = shunting_yard.to_rpn();
+            benchmark::DoNotOptimize(BytecodeCompiler(rpn).compile());
+        }
+        report(state, tokens.size(), allocations);
+    }
+    BENCHMARK(BM_RpnCompile)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 包含词法分析：Pratt 解析器边读 token 边生成字节码，可与 BM_LexerTokenize + BM_RpnCompile 之和对比
+    void BM_PrattParse(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(PrattParser(expression).parse());
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_PrattParse)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 同样包含词法分析：流式调度场，不生成标记数组
+    void BM_StreamingParse(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(StreamingParser(expression).parse());
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_StreamingParse)->RangeMultiplier(8)->Range(8, 4096);
+
+    void BM_EvaluatorEvaluate(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        Calculator calc;
+        SymbolTable symbols;
+        set_variables(calc, symbols, 8);
+        const auto compiled = calc.compile(expression);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            Evaluator evaluator(compiled.bytecode(), symbols);
+            benchmark::DoNotOptimize(evaluator.evaluate());
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_EvaluatorEvaluate)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 账目类表达式：整数变量和常量之间只有加减乘，参数为操作数个数
+    std::string make_ledger_expression(size_t terms) {
+        static const char* const kLedgerOperators[] = {" + ", " * ", " - "};
+        std::string expression;
+        for (size_t i = 0; i < terms; ++i) {
+            if (i > 0) expression += kLedgerOperators[i % 3];
+            expression += i % 2 == 0 ? variable_name(i % 8) : std::to_string(i % 97 + 1);
+        }
+        return expression;
+    }
+
+    // 同一批账目表达式分别用 double、带溢出检查的 int64 和 128 位定点十进制解释执行。
+    // 每次求值都要把变量从 double 转换过来；double 和 int64 的常量池在编译时已转换好
+    template <typename Arithmetic>
+    void BM_LedgerEvaluate(benchmark::State& state) {
+        const std::string expression = make_ledger_expression(state.range(0));
+        Calculator calc;
+        SymbolTable symbols;
+        for (size_t i = 0; i < 8; ++i) {
+            calc.set_variable(variable_name(i), 1000.0 * static_cast<double>(i + 1));
+            symbols.set_variable(variable_name(i), 1000.0 * static_cast<double>(i + 1));
+        }
+        const auto compiled = calc.compile(expression);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        const Arithmetic arithmetic{};
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(compiled.evaluate_as(symbols, arithmetic));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK_TEMPLATE(BM_LedgerEvaluate, DoubleArithmetic)->RangeMultiplier(8)->Range(8, 4096);
+    BENCHMARK_TEMPLATE(BM_LedgerEvaluate, IntegerArithmetic)->RangeMultiplier(8)->Range(8, 4096);
+#if defined(EXPRCALC_HAS_INT128)
+    BENCHMARK_TEMPLATE(BM_LedgerEvaluate, DecimalArithmetic)->RangeMultiplier(8)->Range(8, 4096);
+#endif
+
+    // 只比较解释器本身：常量和变量预先转换好，反复执行同一段字节码
+    template <typename Arithmetic>
+    void BM_LedgerInterpret(benchmark::State& state) {
+        const std::string expression = make_ledger_expression(state.range(0));
+        Calculator calc;
+        for (size_t i = 0; i < 8; ++i) calc.set_variable(variable_name(i), 1234.56 * static_cast<double>(i + 1));
+        const auto compiled = calc.compile_exact(expression);
+        const Bytecode& bytecode = compiled.bytecode();
+        const Arithmetic arithmetic{};
+        std::vector<typename Arithmetic::value_type> constants, slots;
+        for (double constant : bytecode.constants) constants.push_back(arithmetic.from_double(constant));
+        for (size_t i = 0; i < bytecode.variables.size(); ++i) {
+            slots.push_back(arithmetic.from_double(1234.56 * static_cast<double>(i + 1)));
+        }
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(interpret(bytecode, constants.data(), slots.data(), arithmetic));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK_TEMPLATE(BM_LedgerInterpret, DoubleArithmetic)->RangeMultiplier(8)->Range(8, 4096);
+#if defined(EXPRCALC_HAS_INT128)
+    BENCHMARK_TEMPLATE(BM_LedgerInterpret, DecimalArithmetic)->RangeMultiplier(8)->Range(8, 4096);
+#endif
+
+    // 端到端，关闭编译缓存：每次都完整地词法分析、转换、编译、求值
+    void BM_CalculatorEvaluate(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        Calculator calc;
+        SymbolTable symbols;
+        set_variables(calc, symbols, 8);
+        calc.set_cache_capacity(0);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(calc.evaluate(expression));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_CalculatorEvaluate)->RangeMultiplier(8)->Range(8, 4096);
+
+    // 端到端，命中编译缓存
+    void BM_CalculatorEvaluateCached(benchmark::State& state) {
+        const std::string expression = make_chain_expression(state.range(0), 8);
+        Calculator calc;
+        SymbolTable symbols;
+        set_variables(calc, symbols, 8);
+        const size_t tokens = count_tokens(expression);
+        calc.evaluate(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(calc.evaluate(expression));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_CalculatorEvaluateCached)->RangeMultiplier(8)->Range(8, 4096);
+
+    // ---------- 端到端，按括号嵌套深度参数化 ----------
+
+    void BM_CalculatorNestingDepth(benchmark::State& state) {
+        const std::string expression = make_nested_expression(state.range(0), 8);
+        Calculator calc;
+        SymbolTable symbols;
+        set_variables(calc, symbols, 8);
+        calc.set_cache_capacity(0);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(calc.evaluate(expression));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_CalculatorNestingDepth)->RangeMultiplier(4)->Range(1, 256);
+
+    // ---------- 预编译后求值，按变量个数参数化 ----------
+
+    void BM_CompiledVariableCount(benchmark::State& state) {
+        const size_t variables = state.range(0);
+        const std::string expression = make_chain_expression(2 * variables, variables);
+        Calculator calc;
+        SymbolTable symbols;
+        set_variables(calc, symbols, variables);
+        const auto compiled = calc.compile(expression);
+        const size_t tokens = count_tokens(expression);
+        const size_t allocations = allocation_count();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(calc.evaluate(compiled));
+        }
+        report(state, tokens, allocations);
+    }
+    BENCHMARK(BM_CompiledVariableCount)->RangeMultiplier(4)->Range(1, 256);
+
+} // anonymous namespace
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "bench_support.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace exprcalc::bench {
+
+    namespace {
+        const char kOperators[] = {'+', '*', '-', '/'};
+        const char* const kConstants[] = {"1.5", "2.25", "3", "0.75"};
+
+        std::string operand(size_t i, size_t variables) {
+            // 变量与常量交替出现；除数永远不会是 0
+            if (variables > 0 && i % 2 == 0) return variable_name((i / 2) % variables);
+            return kConstants[i % 4];
+        }
+    }
+
+    size_t allocation_count() {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    std::string variable_name(size_t index) {
+        return "v" + std::to_string(index);
+    }
+
+    std::string make_chain_expression(size_t terms, size_t variables) {
+        std::string expression;
+        for (size_t i = 0; i < terms; ++i) {
+            if (i > 0) {
+                expression += ' ';
+                expression += kOperators[i % 4];
+                expression += ' ';
+            }
+            expression += operand(i, variables);
+        }
+        return expression;
+    }
+
+    std::string make_nested_expression(size_t depth, size_t variables) {
+        std::string expression = operand(depth, variables);
+        for (size_t i = depth; i-- > 0;) {
+            expression = operand(i, variables) + " " + kOperators[i % 4] + " (" + expression + ")";
+        }
+        return expression;
+    }
+
+} // namespace exprcalc::bench
@@ -0,0 +1,20 @@
+#ifndef EXPRCALC_BENCH_SUPPORT_H
+#define EXPRCALC_BENCH_SUPPORT_H
+
+#include <cstddef>
+#include <string>
+
+namespace exprcalc::bench {
+
+    // 进程内全局 operator new 的调用次数（基准程序替换了全局分配函数）
+    size_t allocation_count();
+
+    // "v0 + 1.5 * v1 - v2 / 2.25 ..."：terms 个操作数，变量在 v0..v{variables-1} 中循环，variables 为 0 时全是常量
+    std::string make_chain_expression(size_t terms, size_t variables);
+    // "v0 + (1.5 * (v1 - (...)))"：括号嵌套 depth 层
+    std::string make_nested_expression(size_t depth, size_t variables);
+    std::string variable_name(size_t index);
+
+} // namespace exprcalc::bench
+
+#endif // EXPRCALC_BENCH_SUPPORT_H
@@ -1,9 +1,79 @@
+#include "src/batch_pipeline.h"
+#include "src/batch_runner.h"
 #include "src/calculator.h"
 #include "src/error.h"
+#include "src/mapped_file.h"
+#include <charconv>
+#include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 
-int main() {
+namespace {
+    // 解析整个参数为十进制非负整数，有多余字符或超出范围时返回 false
+    bool parse_count(std::string_view text, size_t& value) {
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && ec == std::errc() && end == text.data() + text.size();
+    }
+
+    // ExprCalc --batch [file|-] [--threads N]：从文件或标准输入逐行求值，只输出结果。
+    // N 为 1 时串行处理，否则使用多线程流水线（0 或省略表示硬件线程数）
+    // 普通文件直接映射进内存；标准输入、管道等无法映射的输入按流读取
+    int run_batch(const char* path, size_t threads) {
+        std::ios::sync_with_stdio(false);
+        std::unique_ptr<exprcalc::MappedFile> mapped;
+        std::FILE* in = stdin;
+        if (path && std::string(path) != "-") {
+            try {
+                mapped = std::make_unique<exprcalc::MappedFile>(path);
+            } catch (const std::exception&) {
+                in = std::fopen(path, "rb");
+                if (!in) {
+                    std::fprintf(stderr, "Error: cannot open %s\n", path);
+                    return 1;
+                }
+            }
+        }
+        size_t errors;
+        if (threads == 1) {
+            exprcalc::Calculator calc;
+            calc.set_cache_capacity(0); // 批处理的行大多互不相同，缓存只会带来插入和淘汰开销
+            exprcalc::BatchRunner runner(calc, stdout);
+            if (mapped) runner.run(mapped->view());
+            else runner.run(in);
+            errors = runner.errors();
+        } else {
+            exprcalc::PipelineOptions options;
+            options.threads = threads;
+            exprcalc::BatchPipeline pipeline(stdout, options);
+            if (mapped) pipeline.run(mapped->view());
+            else pipeline.run(in);
+            errors = pipeline.errors();
+        }
+        if (in != stdin) std::fclose(in);
+        return errors == 0 ? 0 : 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        const char* path = nullptr;
+        size_t threads = 0;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threads") {
+                if (i + 1 >= argc || !parse_count(argv[++i], threads)) {
+                    std::fprintf(stderr, "Error: --threads expects a non-negative integer\n"
+                                         "Usage: ExprCalc --batch [file|-] [--threads N]\n");
+                    return 1;
+                }
+            } else {
+                path = argv[i];
+            }
+        }
+        return run_batch(path, threads);
+    }
     std::cout << "ExprCalc: Enter expressions, 'set x = value', 'debug on/off', 'help', or 'exit'\n";
     exprcalc::Calculator calc;
     std::string input;
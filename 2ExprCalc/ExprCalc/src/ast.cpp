@@ -0,0 +1,172 @@
+#include "ast.h"
+#include "error.h"
+#include <utility>
+
+namespace exprcalc {
+
+    void Ast::reserve(size_t nodes) {
+        nodes_.reserve(nodes);
+    }
+
+    void Ast::clear() {
+        nodes_.clear();
+        root_ = kNoNode;
+    }
+
+    Ast::NodeId Ast::add_number(double value, size_t position) {
+        return add({value, {}, position, kNoNode, kNoNode, AstKind::NUMBER, Operator()});
+    }
+
+    Ast::NodeId Ast::add_variable(std::string_view name, size_t position) {
+        return add({0.0, name, position, kNoNode, kNoNode, AstKind::VARIABLE, Operator()});
+    }
+
+    Ast::NodeId Ast::add_binary(Operator op, NodeId lhs, NodeId rhs, size_t position) {
+        return add({0.0, {}, position, lhs, rhs, AstKind::BINARY, op});
+    }
+
+    Ast::NodeId Ast::add(const AstNode& node) {
+        nodes_.push_back(node);
+        return static_cast<NodeId>(nodes_.size() - 1);
+    }
+
+    const AstNode& Ast::node(NodeId id) const {
+        return nodes_[id];
+    }
+
+    size_t Ast::size() const {
+        return nodes_.size();
+    }
+
+    Ast::NodeId Ast::root() const {
+        return root_;
+    }
+
+    void Ast::set_root(NodeId id) {
+        root_ = id;
+    }
+
+    Bytecode Ast::to_bytecode() const {
+        Bytecode bytecode;
+        if (root_ == kNoNode) return bytecode;
+        bytecode.code.reserve(nodes_.size());
+        bytecode.positions.reserve(nodes_.size());
+
+        // 显式栈后序遍历，很深的树也不会耗尽调用栈
+        std::vector<std::pair<NodeId, bool>> work;
+        work.reserve(nodes_.size());
+        work.push_back({root_, false});
+        size_t depth = 0;
+        while (!work.empty()) {
+            auto [id, expanded] = work.back();
+            work.pop_back();
+            const AstNode& node = nodes_[id];
+            Instruction instruction{};
+            switch (node.kind) {
+                case AstKind::NUMBER:
+                    instruction = {OpCode::PUSH_CONST, static_cast<std::uint32_t>(bytecode.constants.size())};
+                    bytecode.constants.push_back(node.number);
+                    ++depth;
+                    break;
+                case AstKind::VARIABLE:
+                    instruction = {OpCode::LOAD_VAR, BytecodeCompiler::variable_slot(bytecode, node.name)};
+                    ++depth;
+                    break;
+                case AstKind::BINARY:
+                    if (!expanded) {
+                        work.push_back({id, true});
+                        work.push_back({node.rhs, false});
+                        work.push_back({node.lhs, false});
+                        continue;
+                    }
+                    instruction = {operator_info(node.op).opcode, 0};
+                    --depth;
+                    break;
+            }
+            bytecode.code.push_back(instruction);
+            bytecode.positions.push_back(node.position);
+            if (depth > bytecode.max_stack) bytecode.max_stack = depth;
+        }
+        return bytecode;
+    }
+
+    AstParser::AstParser(const std::vector<Token>& tokens) : tokens_(tokens) {}
+
+    void AstParser::parse(Ast& ast) {
+        ast.clear();
+        ast.reserve(tokens_.size());
+        std::vector<const Token*> operators; // 运算符和左括号
+        std::vector<Ast::NodeId> operands;
+        operators.reserve(tokens_.size());
+        operands.reserve(tokens_.size() / 2 + 1);
+        bool expect_operand = true;
+
+        auto reduce = [&] {
+            const Token& token = *operators.back();
+            operators.pop_back();
+            Ast::NodeId rhs = operands.back();
+            operands.pop_back();
+            operands.back() = ast.add_binary(token.op, operands.back(), rhs, token.position);
+        };
+
+        for (const auto& token : tokens_) {
+            switch (token.type) {
+                case TokenType::NUMBER:
+                case TokenType::VARIABLE:
+                    if (!expect_operand) throw CalculationError("Invalid token in RPN", token.position);
+                    operands.push_back(token.type == TokenType::NUMBER
+                                           ? ast.add_number(token.number, token.position)
+                                           : ast.add_variable(token.value, token.position));
+                    expect_operand = false;
+                    break;
+
+                case TokenType::OPERATOR: {
+                    if (expect_operand) throw CalculationError("Invalid token in RPN", token.position);
+                    const OperatorInfo& current = operator_info(token.op);
+                    while (!operators.empty() && operators.back()->type != TokenType::LEFT_PAREN) {
+                        const OperatorInfo& stacked = operator_info(operators.back()->op);
+                        bool pops = stacked.precedence != current.precedence
+                                        ? stacked.precedence > current.precedence
+                                        : current.associativity == Associativity::LEFT;
+                        if (!pops) break;
+                        reduce();
+                    }
+                    operators.push_back(&token);
+                    expect_operand = true;
+                    break;
+                }
+
+                case TokenType::LEFT_PAREN:
+                    operators.push_back(&token);
+                    expect_operand = true;
+                    break;
+
+                case TokenType::RIGHT_PAREN:
+                    if (expect_operand) throw CalculationError("Invalid token in RPN", token.position);
+                    while (!operators.empty() && operators.back()->type != TokenType::LEFT_PAREN) reduce();
+                    if (operators.empty()) throw CalculationError("Mismatched parentheses", token.position);
+                    operators.pop_back();
+                    expect_operand = false;
+                    break;
+
+                case TokenType::END:
+                    break;
+            }
+        }
+
+        // 与 ShuntingYard 相同的检查顺序：先找未闭合的左括号（从栈顶开始），再检查结尾缺少操作数
+        for (auto it = operators.rbegin(); it != operators.rend(); ++it) {
+            if ((*it)->type == TokenType::LEFT_PAREN) throw CalculationError("Mismatched parentheses", (*it)->position);
+        }
+        if (expect_operand) {
+            throw CalculationError("Invalid token in RPN", tokens_.empty() ? 0 : tokens_.back().position);
+        }
+        while (!operators.empty()) reduce();
+        // 与 BytecodeCompiler 相同：相邻的操作数（如 "1 (2)"）在这里才被发现
+        if (operands.size() != 1) {
+            throw CalculationError("Invalid RPN expression: too many operands", 0);
+        }
+        ast.set_root(operands.back());
+    }
+
+} // namespace exprcalc
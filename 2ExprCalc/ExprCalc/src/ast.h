@@ -0,0 +1,68 @@
+#ifndef EXPRCALC_AST_H
+#define EXPRCALC_AST_H
+
+#include "bytecode.h"
+#include "token.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace exprcalc {
+
+    enum class AstKind : std::uint8_t {
+        NUMBER,
+        VARIABLE,
+        BINARY
+    };
+
+    struct AstNode {
+        double number;         // NUMBER 的数值
+        std::string_view name; // VARIABLE 的名字，指向输入
+        size_t position;       // 在输入中的位置，用于错误报告
+        std::uint32_t lhs;     // BINARY 的左右子节点下标
+        std::uint32_t rhs;
+        AstKind kind;
+        Operator op;
+    };
+
+    // 抽象语法树。所有节点连续存放在同一块内存（arena）中，用 32 位下标互相引用而不是指针；
+    // 整棵树随 clear() 或析构一次性释放，clear() 后保留容量，反复解析时不再分配
+    class Ast {
+    public:
+        using NodeId = std::uint32_t;
+        static constexpr NodeId kNoNode = static_cast<NodeId>(-1);
+
+        void reserve(size_t nodes);
+        void clear();
+
+        NodeId add_number(double value, size_t position);
+        NodeId add_variable(std::string_view name, size_t position);
+        NodeId add_binary(Operator op, NodeId lhs, NodeId rhs, size_t position);
+
+        const AstNode& node(NodeId id) const;
+        size_t size() const;
+        NodeId root() const;
+        void set_root(NodeId id);
+
+        // 后序遍历生成字节码，与逆波兰序列编译的结果相同
+        Bytecode to_bytecode() const;
+
+    private:
+        std::vector<AstNode> nodes_;
+        NodeId root_ = kNoNode;
+        NodeId add(const AstNode& node);
+    };
+
+    // 从词法单元构造语法树：与 ShuntingYard 相同的算法和错误信息，只是直接建树，不生成逆波兰序列
+    class AstParser {
+    public:
+        explicit AstParser(const std::vector<Token>& tokens);
+        void parse(Ast& ast); // 结果写入 ast（会先清空），根节点为 ast.root()
+
+    private:
+        const std::vector<Token>& tokens_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_AST_H
@@ -0,0 +1,181 @@
+#include "batch_evaluator.h"
+#include "error.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <optional>
+
+namespace exprcalc {
+
+    namespace {
+        constexpr size_t kNoRows = static_cast<size_t>(-1);
+    }
+
+    BatchEvaluator::BatchEvaluator(const Bytecode& bytecode, const ColumnMap& columns, const SymbolTable* scalars)
+        : bytecode_(bytecode), kernels_(&best_kernels()), rows_(kNoRows) {
+        const auto& constants = bytecode_.constants;
+        const auto& variables = bytecode_.variables;
+
+        size_t scalar_count = 0;
+        for (const auto& name : variables) {
+            if (columns.find(name) == columns.end()) ++scalar_count;
+        }
+        broadcast_.reserve((constants.size() + scalar_count) * kBlockSize);
+        for (double constant : constants) {
+            broadcast_.insert(broadcast_.end(), kBlockSize, constant);
+        }
+
+        // 先把所有广播块展开完，避免 vector 扩容导致前面记下的指针失效
+        std::vector<size_t> broadcast_offsets(variables.size(), 0);
+        for (size_t slot = 0; slot < variables.size(); ++slot) {
+            const auto& name = variables[slot];
+            auto it = columns.find(name);
+            if (it != columns.end()) {
+                if (rows_ != kNoRows && it->second.size() != rows_) {
+                    throw CalculationError("Column size mismatch for variable: " + name, 0);
+                }
+                rows_ = it->second.size();
+                continue;
+            }
+            if (scalars == nullptr || !scalars->has_variable(name)) {
+                throw CalculationError("Undefined variable: " + name, 0);
+            }
+            broadcast_offsets[slot] = broadcast_.size();
+            broadcast_.insert(broadcast_.end(), kBlockSize, scalars->get_variable(name));
+        }
+
+        slots_.reserve(variables.size());
+        for (size_t slot = 0; slot < variables.size(); ++slot) {
+            auto it = columns.find(variables[slot]);
+            if (it != columns.end()) {
+                slots_.push_back({it->second.data(), false});
+            } else {
+                slots_.push_back({broadcast_.data() + broadcast_offsets[slot], true});
+            }
+        }
+    }
+
+    void BatchEvaluator::set_simd_level(SimdLevel level) {
+        kernels_ = &kernels_for(level);
+    }
+
+    SimdLevel BatchEvaluator::simd_level() const {
+        return kernels_->level;
+    }
+
+    void BatchEvaluator::evaluate(std::span<double> out) const {
+        evaluate_rows(0, out.size(), out);
+    }
+
+    void BatchEvaluator::evaluate_rows(size_t begin, size_t end, std::span<double> out) const {
+        check_output_size(out);
+        std::vector<double> registers(bytecode_.max_stack * kBlockSize);
+        std::vector<const double*> stack(bytecode_.max_stack);
+        std::vector<double> temps(bytecode_.temp_count * kBlockSize);
+        for (size_t row = begin; row < end; row += kBlockSize) {
+            size_t count = std::min(kBlockSize, end - row);
+            evaluate_block(row, count, registers.data(), stack.data(), temps.data(), out.data() + row);
+        }
+    }
+
+    void BatchEvaluator::evaluate_parallel(std::span<double> out, ThreadPool& pool, size_t chunk_rows) const {
+        check_output_size(out);
+        if (chunk_rows == 0) chunk_rows = default_chunk_rows();
+        const size_t rows = out.size();
+        const size_t chunks = (rows + chunk_rows - 1) / chunk_rows;
+
+        // 每个块只写自己的错误槽位，无需加锁
+        std::vector<std::optional<BatchError>> errors(chunks);
+        std::vector<ThreadPool::Task> tasks;
+        tasks.reserve(chunks);
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            tasks.push_back([this, out, chunk, chunk_rows, rows, &errors] {
+                size_t begin = chunk * chunk_rows;
+                try {
+                    evaluate_rows(begin, std::min(begin + chunk_rows, rows), out);
+                } catch (const BatchError& e) {
+                    errors[chunk] = e;
+                }
+            });
+        }
+        pool.run(std::move(tasks));
+
+        // 块按行号递增排列，第一个出错的块里就是行号最小的错误
+        for (const auto& error : errors) {
+            if (error) throw *error;
+        }
+    }
+
+    void BatchEvaluator::check_output_size(std::span<double> out) const {
+        if (rows_ != kNoRows && out.size() != rows_) {
+            throw CalculationError("Output size does not match column size", 0);
+        }
+    }
+
+    size_t BatchEvaluator::default_chunk_rows() const {
+        // 让一个块所读写的列数据大致装得进 L2：每行读取所有列，写一个结果
+        const size_t bytes_per_row = (slots_.size() + 1) * sizeof(double);
+        size_t rows = l2_cache_size() / 2 / bytes_per_row;
+        rows -= rows % kBlockSize;
+        return std::max(rows, kBlockSize);
+    }
+
+    void BatchEvaluator::evaluate_block(size_t row, size_t count, double* registers, const double** stack,
+                                        double* temps, double* out) const {
+        const Instruction* code = bytecode_.code.data();
+        const size_t size = bytecode_.code.size();
+        size_t top = 0;
+
+        for (size_t pc = 0; pc < size; ++pc) {
+            const Instruction instruction = code[pc];
+            if (instruction.op == OpCode::PUSH_CONST) {
+                stack[top++] = broadcast_.data() + instruction.operand * kBlockSize;
+                continue;
+            }
+            if (instruction.op == OpCode::LOAD_VAR) {
+                const Slot& slot = slots_[instruction.operand];
+                stack[top++] = slot.broadcast ? slot.data : slot.data + row;
+                continue;
+            }
+            if (instruction.op == OpCode::LOAD_TEMP) {
+                stack[top++] = temps + instruction.operand * kBlockSize;
+                continue;
+            }
+            if (instruction.op == OpCode::STORE_TEMP) {
+                // 栈顶所在的寄存器块之后会被覆盖，先复制出来
+                double* temp = temps + instruction.operand * kBlockSize;
+                std::copy(stack[top - 1], stack[top - 1] + count, temp);
+                stack[top - 1] = temp;
+                continue;
+            }
+            if (instruction.op == OpCode::NEG) {
+                const double* a = stack[top - 1];
+                double* result = registers + (top - 1) * kBlockSize;
+                for (size_t i = 0; i < count; ++i) result[i] = -a[i];
+                stack[top - 1] = result;
+                continue;
+            }
+
+            --top;
+            const double* a = stack[top - 1];
+            const double* b = stack[top];
+            double* result = registers + (top - 1) * kBlockSize;
+            switch (instruction.op) {
+                case OpCode::ADD: kernels_->add(a, b, result, count); break;
+                case OpCode::SUB: kernels_->sub(a, b, result, count); break;
+                case OpCode::MUL: kernels_->mul(a, b, result, count); break;
+                case OpCode::DIV: {
+                    size_t zero = kernels_->div(a, b, result, count);
+                    if (zero != count) {
+                        throw BatchError("Division by zero", bytecode_.positions[pc], row + zero);
+                    }
+                    break;
+                }
+                default: break;
+            }
+            stack[top - 1] = result;
+        }
+        std::copy(stack[0], stack[0] + count, out);
+    }
+
+} // namespace exprcalc
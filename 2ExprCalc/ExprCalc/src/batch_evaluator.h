@@ -0,0 +1,55 @@
+#ifndef EXPRCALC_BATCH_EVALUATOR_H
+#define EXPRCALC_BATCH_EVALUATOR_H
+
+#include "bytecode.h"
+#include "cpu_features.h"
+#include "symbol_table.h"
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace exprcalc {
+
+    struct KernelTable;
+    class ThreadPool;
+
+    // 变量名 -> 该变量在每一行上的取值（列式存储）
+    using ColumnMap = std::map<std::string, std::span<const double>>;
+
+    // 列式批量求值：按块（kBlockSize 行）逐条指令执行，每条指令都是一个可自动向量化的循环
+    class BatchEvaluator {
+    public:
+        static constexpr size_t kBlockSize = 256;
+
+        // 没有对应列的变量从 scalars 中取值并广播到所有行
+        BatchEvaluator(const Bytecode& bytecode, const ColumnMap& columns, const SymbolTable* scalars = nullptr);
+        // 默认使用当前 CPU 支持的最宽 SIMD 内核，可以降级（例如用于对比测试）
+        void set_simd_level(SimdLevel level);
+        SimdLevel simd_level() const;
+        void evaluate(std::span<double> out) const;
+        void evaluate_rows(size_t begin, size_t end, std::span<double> out) const; // 只计算 [begin, end) 行
+        // 按行区间切块交给线程池并行计算，输出顺序与串行一致；
+        // 若有多行出错，所有块跑完后抛出行号最小的 BatchError。chunk_rows 为 0 时按 L2 大小自动选择
+        void evaluate_parallel(std::span<double> out, ThreadPool& pool, size_t chunk_rows = 0) const;
+
+    private:
+        struct Slot {
+            const double* data;
+            bool broadcast; // true 时 data 指向广播块，不随行号偏移
+        };
+
+        const Bytecode& bytecode_;
+        const KernelTable* kernels_;
+        std::vector<Slot> slots_;
+        std::vector<double> broadcast_; // 常量与标量变量预先展开成的整块
+        size_t rows_;
+        void check_output_size(std::span<double> out) const;
+        size_t default_chunk_rows() const;
+        void evaluate_block(size_t row, size_t count, double* registers, const double** stack, double* temps,
+                            double* out) const;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_BATCH_EVALUATOR_H
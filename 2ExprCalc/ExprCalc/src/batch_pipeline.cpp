@@ -0,0 +1,156 @@
+#include "batch_pipeline.h"
+#include "batch_runner.h"
+#include "calculator.h"
+#include "spsc_queue.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <thread>
+
+namespace exprcalc {
+
+    namespace {
+        constexpr size_t kBlockBytes = 256 * 1024;
+    }
+
+    struct BatchPipeline::LineBlock {
+        std::string storage;                               // 从流读取时保存块内各行的副本
+        std::string_view text;                             // 以 '\n' 分隔的各行，指向 storage 或映射文件
+        std::vector<std::uint32_t> ends;                   // 每行在 text 中的结束位置
+        std::shared_ptr<const VariableSnapshot> variables; // 块开始前已定义的全部变量
+        std::string output;
+        size_t lines = 0;
+        size_t errors = 0;
+    };
+
+    BatchPipeline::BatchPipeline(std::FILE* out, PipelineOptions options)
+        : out_(out), options_(options), lines_(0), errors_(0) {
+        if (options_.threads == 0) options_.threads = std::max(1u, std::thread::hardware_concurrency());
+        options_.block_lines = std::max<size_t>(options_.block_lines, 1);
+        options_.queue_depth = std::max<size_t>(options_.queue_depth, 2);
+    }
+
+    void BatchPipeline::run(std::FILE* in) {
+        run_lines([in](auto&& callback) { for_each_line(in, callback); }, false);
+    }
+
+    void BatchPipeline::run(std::string_view data) {
+        run_lines([data](auto&& callback) { for_each_line(data, callback); }, true);
+    }
+
+    template <typename Source>
+    void BatchPipeline::run_lines(Source&& source, bool borrowed) {
+        using BlockPtr = std::unique_ptr<LineBlock>;
+        size_t worker_count = options_.threads;
+        std::vector<std::unique_ptr<SpscQueue<BlockPtr>>> inputs, outputs;
+        for (size_t i = 0; i < worker_count; ++i) {
+            inputs.push_back(std::make_unique<SpscQueue<BlockPtr>>(options_.queue_depth));
+            outputs.push_back(std::make_unique<SpscQueue<BlockPtr>>(options_.queue_depth));
+        }
+
+        // 求值线程：空指针表示输入结束，转发给写线程
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers.emplace_back([&input = *inputs[i], &output = *outputs[i], cache_capacity = options_.cache_capacity] {
+                Calculator calc;
+                calc.set_cache_capacity(cache_capacity);
+                std::shared_ptr<const VariableSnapshot> applied;
+                while (BlockPtr block = input.pop()) {
+                    if (block->variables != applied) {
+                        for (const auto& [name, value] : *block->variables) calc.set_variable(name, value);
+                        applied = block->variables;
+                    }
+                    std::string_view text = block->text;
+                    std::uint32_t begin = 0;
+                    for (std::uint32_t end : block->ends) {
+                        LineResult result = BatchRunner::handle_line(calc, text.substr(begin, end - begin), block->output);
+                        if (result != LineResult::SKIPPED) ++block->lines;
+                        if (result == LineResult::FAILED) ++block->errors;
+                        begin = end + 1;
+                    }
+                    output.push(std::move(block));
+                }
+                output.push(nullptr);
+            });
+        }
+
+        // 写线程：按分发顺序轮流从各求值线程取结果
+        std::thread writer([&] {
+            for (size_t next = 0;; ++next) {
+                BlockPtr block = outputs[next % worker_count]->pop();
+                if (!block) break;
+                std::fwrite(block->output.data(), 1, block->output.size(), out_);
+                lines_ += block->lines;
+                errors_ += block->errors;
+            }
+            std::fflush(out_);
+        });
+
+        // 读线程（当前线程）：切分行块，并跟踪 set 命令以生成后续块的变量快照。
+        // 输入来自映射内存时块内各行本就连续，块只记录范围，不复制行内容
+        std::map<std::string, double, std::less<>> variables;
+        auto snapshot = std::make_shared<const VariableSnapshot>();
+        bool variables_changed = false;
+        size_t dispatched = 0;
+        BlockPtr block;
+        const char* block_begin = nullptr;
+        auto dispatch = [&] {
+            if (!block) return;
+            if (!borrowed) block->text = block->storage;
+            inputs[dispatched++ % worker_count]->push(std::move(block));
+            block = nullptr;
+        };
+
+        source([&](std::string_view line) {
+            if (!block) {
+                if (variables_changed) {
+                    snapshot = std::make_shared<const VariableSnapshot>(variables.begin(), variables.end());
+                    variables_changed = false;
+                }
+                block = std::make_unique<LineBlock>();
+                block->variables = snapshot;
+                block->ends.reserve(options_.block_lines);
+                block_begin = line.data();
+            }
+            size_t block_bytes;
+            if (borrowed) {
+                block_bytes = static_cast<size_t>(line.data() + line.size() - block_begin);
+                block->text = std::string_view(block_begin, block_bytes);
+            } else {
+                if (!block->ends.empty()) block->storage += '\n';
+                block->storage.append(line);
+                block_bytes = block->storage.size();
+            }
+            block->ends.push_back(static_cast<std::uint32_t>(block_bytes));
+
+            std::string_view name;
+            double value;
+            try {
+                if (BatchRunner::parse_set_command(BatchRunner::trim(line), name, value)) {
+                    auto it = variables.find(name);
+                    if (it == variables.end()) variables.emplace(std::string(name), value);
+                    else it->second = value;
+                    variables_changed = true;
+                }
+            } catch (const std::exception&) {
+                // 格式错误的 set 命令由求值线程报告
+            }
+
+            if (block->ends.size() >= options_.block_lines || block_bytes >= kBlockBytes) dispatch();
+        });
+        dispatch();
+        for (auto& input : inputs) input->push(nullptr);
+
+        for (auto& worker : workers) worker.join();
+        writer.join();
+    }
+
+    size_t BatchPipeline::lines_processed() const {
+        return lines_;
+    }
+
+    size_t BatchPipeline::errors() const {
+        return errors_;
+    }
+
+} // namespace exprcalc
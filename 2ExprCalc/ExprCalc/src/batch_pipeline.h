@@ -0,0 +1,48 @@
+#ifndef EXPRCALC_BATCH_PIPELINE_H
+#define EXPRCALC_BATCH_PIPELINE_H
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace exprcalc {
+
+    struct PipelineOptions {
+        size_t threads = 0;        // 求值线程数，0 表示使用硬件线程数
+        size_t block_lines = 4096; // 每个行块的最大行数
+        size_t queue_depth = 8;    // 每个求值线程输入/输出队列能容纳的行块数
+        size_t cache_capacity = 0; // 每个求值线程的编译缓存容量；批处理的行大多互不相同，默认关闭
+    };
+
+    // 多线程批处理流水线：读线程 → 并行求值线程 → 按序写线程。
+    // 读线程把输入切成行块，轮流分给各求值线程的 SPSC 队列；写线程按同样的轮转顺序
+    // 取回结果，所以输出顺序与输入一致。每个求值线程有自己的 Calculator，
+    // 行块携带块开始前的变量快照，保证 set 命令与串行处理的语义相同
+    class BatchPipeline {
+    public:
+        BatchPipeline(std::FILE* out, PipelineOptions options = {});
+
+        void run(std::FILE* in);
+        void run(std::string_view data); // 整块内存输入（例如 MappedFile），行不复制
+        size_t lines_processed() const;
+        size_t errors() const;
+
+    private:
+        using VariableSnapshot = std::vector<std::pair<std::string, double>>;
+        struct LineBlock;
+
+        std::FILE* out_;
+        PipelineOptions options_;
+        size_t lines_;
+        size_t errors_;
+
+        template <typename Source>
+        void run_lines(Source&& source, bool borrowed);
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_BATCH_PIPELINE_H
@@ -0,0 +1,112 @@
+#include "batch_runner.h"
+#include "error.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace exprcalc {
+
+    BatchRunner::BatchRunner(Calculator& calc, std::FILE* out)
+        : calc_(calc), out_(out), lines_(0), errors_(0) {
+        output_.reserve(kBufferSize + 256);
+    }
+
+    BatchRunner::~BatchRunner() {
+        flush();
+    }
+
+    void BatchRunner::run(std::FILE* in) {
+        for_each_line(in, [this](std::string_view line) { process_line(line); });
+        flush();
+    }
+
+    void BatchRunner::run(std::string_view data) {
+        for_each_line(data, [this](std::string_view line) { process_line(line); });
+        flush();
+    }
+
+    void BatchRunner::process_line(std::string_view line) {
+        LineResult result = handle_line(calc_, line, output_);
+        if (result == LineResult::SKIPPED) return;
+        ++lines_;
+        if (result == LineResult::FAILED) ++errors_;
+        if (output_.size() >= kBufferSize) flush();
+    }
+
+    LineResult BatchRunner::handle_line(Calculator& calc, std::string_view line, std::string& out) {
+        line = trim(line);
+        if (line.empty()) return LineResult::SKIPPED;
+        try {
+            std::string_view name;
+            double value;
+            if (parse_set_command(line, name, value)) {
+                calc.set_variable(std::string(name), value);
+                return LineResult::OK;
+            }
+            append_number(out, calc.evaluate(line));
+            out += '\n';
+        } catch (const CalculationError& e) {
+            out += "Error: ";
+            out += e.what();
+            out += " at position ";
+            append_number(out, static_cast<double>(e.get_position()));
+            out += '\n';
+            return LineResult::FAILED;
+        } catch (const std::exception& e) {
+            out += "Error: ";
+            out += e.what();
+            out += '\n';
+            return LineResult::FAILED;
+        }
+        return LineResult::OK;
+    }
+
+    void BatchRunner::flush() {
+        if (output_.empty()) return;
+        std::fwrite(output_.data(), 1, output_.size(), out_);
+        std::fflush(out_);
+        output_.clear();
+    }
+
+    size_t BatchRunner::lines_processed() const {
+        return lines_;
+    }
+
+    size_t BatchRunner::errors() const {
+        return errors_;
+    }
+
+    std::string_view BatchRunner::trim(std::string_view text) {
+        const char* whitespace = " \t\r\n";
+        size_t begin = text.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos) return {};
+        size_t end = text.find_last_not_of(whitespace);
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool BatchRunner::parse_set_command(std::string_view line, std::string_view& name, double& value) {
+        if (line.substr(0, 4) != "set ") return false;
+        size_t eq = line.find('=');
+        if (eq == std::string_view::npos) throw std::runtime_error("Invalid set command");
+        name = trim(line.substr(4, eq - 4));
+        std::string_view text = trim(line.substr(eq + 1));
+        if (name.empty()) throw std::runtime_error("Invalid set command");
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || end != text.data() + text.size()) {
+            throw std::runtime_error("Invalid value in set command");
+        }
+        return true;
+    }
+
+    void BatchRunner::append_number(std::string& out, double value) {
+        // 常见量级用定点格式（避免 200000 输出成 2e+05），其余交给最短表示
+        char digits[64];
+        double magnitude = std::fabs(value);
+        bool fixed = magnitude == 0.0 || (magnitude >= 1e-4 && magnitude < 1e15);
+        auto [end, ec] = fixed ? std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed)
+                               : std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, ec == std::errc() ? static_cast<size_t>(end - digits) : 0);
+    }
+
+} // namespace exprcalc
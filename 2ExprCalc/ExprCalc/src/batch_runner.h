@@ -0,0 +1,98 @@
+#ifndef EXPRCALC_BATCH_RUNNER_H
+#define EXPRCALC_BATCH_RUNNER_H
+
+#include "calculator.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace exprcalc {
+
+    enum class LineResult { SKIPPED, OK, FAILED };
+
+    // 按大块读取 in，逐行回调（不含换行符）；跨越两次读取的行会先拼接完整
+    template <typename Callback>
+    void for_each_line(std::FILE* in, Callback&& callback) {
+        std::vector<char> buffer(1 << 20);
+        std::string carry;
+        size_t read;
+        while ((read = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+            std::string_view chunk(buffer.data(), read);
+            size_t newline = chunk.find('\n');
+            if (newline == std::string_view::npos) {
+                carry.append(chunk);
+                continue;
+            }
+            if (!carry.empty()) {
+                carry.append(chunk.substr(0, newline));
+                callback(std::string_view(carry));
+                carry.clear();
+            } else {
+                callback(chunk.substr(0, newline));
+            }
+            size_t start = newline + 1;
+            while ((newline = chunk.find('\n', start)) != std::string_view::npos) {
+                callback(chunk.substr(start, newline - start));
+                start = newline + 1;
+            }
+            carry.assign(chunk.substr(start));
+        }
+        if (!carry.empty()) callback(std::string_view(carry));
+    }
+
+    // 扫描内存中的整块输入（例如映射文件），回调的行直接指向 data，不复制
+    template <typename Callback>
+    void for_each_line(std::string_view data, Callback&& callback) {
+        const char* pos = data.data();
+        const char* end = pos + data.size();
+        while (pos < end) {
+            auto newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+            if (newline == nullptr) {
+                callback(std::string_view(pos, static_cast<size_t>(end - pos)));
+                break;
+            }
+            callback(std::string_view(pos, static_cast<size_t>(newline - pos)));
+            pos = newline + 1;
+        }
+    }
+
+    // 非交互批处理：每行一个表达式或 "set x = value" 命令。
+    // 表达式每行输出一个结果（或 "Error: ..."），set 命令和空行不产生输出。
+    // 输入按大块读取，输出先攒进大缓冲区再整块写出，全程不经过 iostream
+    class BatchRunner {
+    public:
+        static constexpr size_t kBufferSize = 1 << 20;
+
+        BatchRunner(Calculator& calc, std::FILE* out);
+        ~BatchRunner();
+        BatchRunner(const BatchRunner&) = delete;
+        BatchRunner& operator=(const BatchRunner&) = delete;
+
+        void run(std::FILE* in);
+        void run(std::string_view data);
+        void process_line(std::string_view line);
+        void flush();
+        size_t lines_processed() const;
+        size_t errors() const;
+
+        // 处理一行：结果或错误信息追加到 out，set 命令只修改 calc 的变量
+        static LineResult handle_line(Calculator& calc, std::string_view line, std::string& out);
+        static std::string_view trim(std::string_view text);
+        // 解析 "set name = value"，不是 set 命令时返回 false，格式错误时抛出异常
+        static bool parse_set_command(std::string_view line, std::string_view& name, double& value);
+        // 以最短可往返的形式把数值追加到 out
+        static void append_number(std::string& out, double value);
+
+    private:
+        Calculator& calc_;
+        std::FILE* out_;
+        std::string output_;
+        size_t lines_;
+        size_t errors_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_BATCH_RUNNER_H
@@ -0,0 +1,59 @@
+#include "bytecode.h"
+#include "error.h"
+
+namespace exprcalc {
+
+    BytecodeCompiler::BytecodeCompiler(const std::vector<Token>& rpn) : rpn_(rpn) {}
+
+    Bytecode BytecodeCompiler::compile() {
+        Bytecode bytecode;
+        bytecode.code.reserve(rpn_.size());
+        bytecode.positions.reserve(rpn_.size());
+        size_t depth = 0;
+
+        for (const auto& token : rpn_) {
+            Instruction instruction{};
+            switch (token.type) {
+                case TokenType::NUMBER:
+                    instruction = {OpCode::PUSH_CONST, static_cast<std::uint32_t>(bytecode.constants.size())};
+                    bytecode.constants.push_back(token.number);
+                    ++depth;
+                    break;
+
+                case TokenType::VARIABLE:
+                    instruction = {OpCode::LOAD_VAR, variable_slot(bytecode, token.value)};
+                    ++depth;
+                    break;
+
+                case TokenType::OPERATOR:
+                    if (depth < 2) {
+                        throw CalculationError("Insufficient operands for operator " + std::string(token.value), token.position);
+                    }
+                    instruction = {operator_info(token.op).opcode, 0};
+                    --depth;
+                    break;
+
+                default:
+                    throw CalculationError("Invalid token in RPN", token.position);
+            }
+            bytecode.code.push_back(instruction);
+            bytecode.positions.push_back(token.position);
+            if (depth > bytecode.max_stack) bytecode.max_stack = depth;
+        }
+
+        // 栈深度在编译期即可确定，运行时无需再检查操作数个数
+        if (depth != 1) {
+            throw CalculationError("Invalid RPN expression: too many operands", 0);
+        }
+        return bytecode;
+    }
+
+    std::uint32_t BytecodeCompiler::variable_slot(Bytecode& bytecode, std::string_view name) {
+        for (size_t i = 0; i < bytecode.variables.size(); ++i) {
+            if (bytecode.variables[i] == name) return static_cast<std::uint32_t>(i);
+        }
+        bytecode.variables.emplace_back(name);
+        return static_cast<std::uint32_t>(bytecode.variables.size() - 1);
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,35 @@
+#ifndef EXPRCALC_BYTECODE_H
+#define EXPRCALC_BYTECODE_H
+
+#include "opcode.h"
+#include "token.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace exprcalc {
+
+    // 由逆波兰序列降级得到的紧凑字节码，求值时不再涉及任何字符串操作
+    struct Bytecode {
+        std::vector<Instruction> code;
+        std::vector<double> constants;        // 预先解析好的数字常量
+        std::vector<std::string> variables;   // 槽位 -> 变量名
+        std::vector<size_t> positions;        // 每条指令在输入中的位置，用于错误报告
+        size_t max_stack = 0;                 // 求值所需的最大栈深度
+        size_t temp_count = 0;                // 公共子表达式占用的临时槽位数
+    };
+
+    class BytecodeCompiler {
+    public:
+        explicit BytecodeCompiler(const std::vector<Token>& rpn);
+        Bytecode compile();
+        // 变量名 -> 槽位，第一次出现时分配新槽位
+        static std::uint32_t variable_slot(Bytecode& bytecode, std::string_view name);
+
+    private:
+        const std::vector<Token>& rpn_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_BYTECODE_H
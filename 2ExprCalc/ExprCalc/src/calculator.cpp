@@ -1,32 +1,213 @@
 #include "calculator.h"
 #include "error.h"
+#include <utility>
 
 namespace exprcalc {
 
-    Calculator::Calculator() : symbols_(), logger_() {}
+    namespace {
+        constexpr size_t kDefaultCacheCapacity = 1024;
+    }
+
+    Calculator::Calculator()
+        : symbols_(), logger_(), jit_enabled_(false), optimizer_options_(), front_end_(FrontEnd::STREAMING), cache_(kDefaultCacheCapacity),
+#if defined(EXPRCALC_HAS_INT128)
+          decimal_cache_(kDefaultCacheCapacity),
+#endif
+          normalize_whitespace_(false) {}
+
+    // 取得（必要时用 compile 编译并放入 cache）表达式的编译结果，交给 evaluate 求值
+    template <typename Compile, typename Evaluate>
+    auto Calculator::with_compiled(ExpressionCache& cache, std::string_view expression, Compile&& compile,
+                                   Evaluate&& evaluate) {
+        if (cache.capacity() == 0 || logger_.is_enabled()) {
+            return evaluate(compile(expression));
+        }
+        std::string_view key = expression;
+        if (normalize_whitespace_) {
+            ExpressionCache::normalize(expression, cache_key_);
+            key = cache_key_;
+        }
+        auto compiled = cache.find(key);
+        if (!compiled) {
+            compiled = std::make_shared<const CompiledExpression>(compile(expression));
+            cache.insert(key, compiled);
+        }
+        return evaluate(*compiled);
+    }
+
+    template <typename Evaluate>
+    auto Calculator::with_compiled(std::string_view expression, Evaluate&& evaluate) {
+        return with_compiled(cache_, expression, [this](std::string_view text) { return compile(text); },
+                             std::forward<Evaluate>(evaluate));
+    }
+
+    double Calculator::evaluate(std::string_view expression) {
+        return with_compiled(expression, [this](const CompiledExpression& compiled) { return evaluate(compiled); });
+    }
+
+    IntegerValue Calculator::evaluate_integer(std::string_view expression) {
+        return with_compiled(expression, [this](const CompiledExpression& compiled) {
+            IntegerValue result = compiled.evaluate_as<IntegerArithmetic>(symbols_);
+            logger_.log_result(result.to_double());
+            return result;
+        });
+    }
+
+#if defined(EXPRCALC_HAS_INT128)
+    Decimal Calculator::evaluate_decimal(std::string_view expression) {
+        return with_compiled(
+            decimal_cache_, expression, [this](std::string_view text) { return compile_exact(text); },
+            [this](const CompiledExpression& compiled) { return evaluate_decimal(compiled); });
+    }
+
+    Decimal Calculator::evaluate_decimal(const CompiledExpression& compiled) const {
+        Decimal result = decimal_.to_decimal(compiled.evaluate_as(symbols_, decimal_));
+        logger_.log_result(result.to_double());
+        return result;
+    }
+
+    void Calculator::set_decimal_options(const DecimalOptions& options) {
+        decimal_ = DecimalArithmetic(options);
+        decimal_cache_.clear(); // 已缓存的常量池是按旧的小数位数和舍入模式转换的
+    }
+
+    CacheStats Calculator::decimal_cache_stats() const {
+        return decimal_cache_.stats();
+    }
+#endif
+
+    // 两个编译缓存都按当前的前端、优化选项和空白规范化方式生成，这些设置改变时一并清空
+    void Calculator::clear_caches() {
+        cache_.clear();
+#if defined(EXPRCALC_HAS_INT128)
+        decimal_cache_.clear();
+#endif
+    }
+
+    double Calculator::evaluate(const CompiledExpression& compiled) const {
+        double result = compiled.evaluate(symbols_);
+        logger_.log_result(result);
+        return result;
+    }
+
+    void Calculator::evaluate_batch(const std::string& expression, const ColumnMap& columns, std::span<double> out) {
+        evaluate_batch(compile(expression), columns, out);
+    }
+
+    void Calculator::evaluate_batch(const CompiledExpression& compiled, const ColumnMap& columns,
+                                    std::span<double> out) const {
+        compiled.evaluate_batch(columns, out, &symbols_, pool_.get());
+    }
 
-    double Calculator::evaluate(const std::string& expression) {
+    CompiledExpression Calculator::compile(std::string_view expression) {
+        CompiledExpression compiled = compile_with(expression, optimizer_options_);
+        if (jit_enabled_) compiled.enable_jit();
+        return compiled;
+    }
+
+    CompiledExpression Calculator::compile_exact(std::string_view expression) {
+        OptimizerOptions options = optimizer_options_;
+        // 折叠、代数化简和公共子表达式消除都按 double 比较或计算常量：
+        // 舍入到 1.0 或 0.0 的字面量会被当作单位元删掉，只在 double 精度之外不同的字面量会被合并
+        options.fold_constants = false;
+        options.simplify_identities = false;
+        options.unsafe_identities = false;
+        options.eliminate_common_subexpressions = false;
+        CompiledExpression compiled = compile_with(expression, options);
+#if defined(EXPRCALC_HAS_INT128)
+        compiled.prepare_decimal(expression, decimal_);
+#endif
+        return compiled;
+    }
+
+    CompiledExpression Calculator::compile_with(std::string_view expression, const OptimizerOptions& options) {
+        CompiledExpression compiled = parse(expression);
+        logger_.log_optimization(compiled.optimize(options));
+        compiled.prepare_integer(expression);
+        compiled.bind(symbols_);
+        return compiled;
+    }
+
+    CompiledExpression Calculator::parse(std::string_view expression) {
+        if (front_end_ == FrontEnd::PRATT) {
+            if (logger_.is_enabled()) logger_.log_tokens(Lexer(expression).tokenize()); // 仅调试模式额外分词一次
+            return CompiledExpression(PrattParser(expression).parse());
+        }
+        // 调试模式要打印标记和逆波兰序列，流式前端退回到先分词的路径
+        if (front_end_ == FrontEnd::STREAMING && !logger_.is_enabled()) {
+            return CompiledExpression(StreamingParser(expression).parse());
+        }
         Lexer lexer(expression);
         auto tokens = lexer.tokenize();
         logger_.log_tokens(tokens);
+        return front_end_ == FrontEnd::AST ? compile_ast(tokens) : compile_rpn(tokens);
+    }
 
+    CompiledExpression Calculator::compile_rpn(const std::vector<Token>& tokens) {
         ShuntingYard shunting_yard(tokens);
         auto rpn = shunting_yard.to_rpn();
         logger_.log_rpn(rpn);
+        return CompiledExpression(rpn);
+    }
 
-        Evaluator evaluator(rpn, symbols_);
-        double result = evaluator.evaluate();
-        logger_.log_result(result);
-
-        return result;
+    CompiledExpression Calculator::compile_ast(const std::vector<Token>& tokens) {
+        AstParser(tokens).parse(ast_);
+        return CompiledExpression(ast_.to_bytecode());
     }
 
     void Calculator::set_variable(const std::string& name, double value) {
         symbols_.set_variable(name, value);
     }
 
+    VariableRef Calculator::variable(std::string_view name) {
+        return symbols_.intern(name);
+    }
+
+    void Calculator::set_variable(VariableRef ref, double value) {
+        symbols_.set(ref, value);
+    }
+
     void Calculator::set_debug_mode(bool enabled) {
         logger_.set_enabled(enabled);
     }
 
+    void Calculator::set_jit_enabled(bool enabled) {
+        jit_enabled_ = enabled;
+        cache_.clear(); // 已缓存的编译结果是按旧设置生成的
+    }
+
+    void Calculator::set_cache_capacity(size_t capacity) {
+        cache_.set_capacity(capacity);
+#if defined(EXPRCALC_HAS_INT128)
+        decimal_cache_.set_capacity(capacity);
+#endif
+    }
+
+    void Calculator::set_cache_normalize_whitespace(bool enabled) {
+        normalize_whitespace_ = enabled;
+        clear_caches();
+    }
+
+    CacheStats Calculator::cache_stats() const {
+        return cache_.stats();
+    }
+
+    void Calculator::set_front_end(FrontEnd front_end) {
+        front_end_ = front_end;
+        clear_caches();
+    }
+
+    void Calculator::set_optimizer_options(const OptimizerOptions& options) {
+        optimizer_options_ = options;
+        clear_caches();
+    }
+
+    void Calculator::set_batch_threads(size_t threads) {
+        if (threads == 1) {
+            pool_.reset();
+        } else {
+            pool_ = std::make_shared<ThreadPool>(threads);
+        }
+    }
+
 } // namespace exprcalc
\ No newline at end of file
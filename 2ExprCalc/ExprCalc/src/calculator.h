@@ -3,23 +3,101 @@
 
 #include "lexer.h"
 #include "shunting_yard.h"
+#include "ast.h"
+#include "pratt_parser.h"
+#include "streaming_parser.h"
 #include "evaluator.h"
 #include "symbol_table.h"
+#include "compiled_expression.h"
+#include "decimal.h"
 #include "logger.h"
+#include "expression_cache.h"
+#include "thread_pool.h"
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace exprcalc {
 
+    // 把词法单元变成字节码的方式
+    enum class FrontEnd {
+        STREAMING,     // 默认：边分词边做调度场，直接生成字节码，内存只与嵌套深度有关
+        SHUNTING_YARD, // 先生成逆波兰序列再编译
+        AST,           // 先在 arena 中建语法树再编译
+        PRATT          // 边分词边解析，直接生成字节码；支持前缀负号
+    };
+
     class Calculator {
     public:
         Calculator();
-        double evaluate(const std::string& expression);
+        double evaluate(std::string_view expression);
+        double evaluate(const CompiledExpression& compiled) const; // 使用计算器当前的变量求值
+        // 整数模式：整数之间的加减乘精确计算并检查溢出，溢出、除不尽或遇到非整数时才退化为 double。
+        // 与 evaluate 共用编译缓存；2^53 以上的整数常量按字面量文本读取，变量仍以 double 存储，超过 2^53 的值在进入前就已舍入
+        IntegerValue evaluate_integer(std::string_view expression);
+#if defined(EXPRCALC_HAS_INT128)
+        // 定点十进制模式：128 位整数按 set_decimal_options 的小数位数和舍入模式计算。
+        // 用 compile_exact 编译，结果放在独立的编译缓存中，改变十进制选项时清空。
+        // 常量按源文本中的字面量精确转换；变量仍以 double 保存，按其最短十进制表示转换，15 位有效数字以内的值是精确的
+        Decimal evaluate_decimal(std::string_view expression);
+        // compiled 应由 compile_exact 生成，常量池在编译时按当时的十进制选项转换好
+        Decimal evaluate_decimal(const CompiledExpression& compiled) const;
+        void set_decimal_options(const DecimalOptions& options);
+        CacheStats decimal_cache_stats() const;
+#endif
+        // 列式批量求值：columns 中没有的变量使用计算器当前的值
+        void evaluate_batch(const std::string& expression, const ColumnMap& columns, std::span<double> out);
+        void evaluate_batch(const CompiledExpression& compiled, const ColumnMap& columns, std::span<double> out) const;
+        // 编译时把变量登记到计算器的符号表，之后用该计算器求值不再按名字查找
+        CompiledExpression compile(std::string_view expression);
+        // 不做按 double 进行的常量折叠、代数化简和公共子表达式消除，也不生成本机代码，并按字面量文本准备十进制常量池，
+        // 供十进制等精确数值模式使用
+        CompiledExpression compile_exact(std::string_view expression);
         void set_variable(const std::string& name, double value);
+        VariableRef variable(std::string_view name); // 获取变量句柄，之后可无哈希地更新
+        void set_variable(VariableRef ref, double value);
         void set_debug_mode(bool enabled);
+        // 批量求值使用的线程数：1 为串行（默认），0 表示使用全部硬件线程
+        void set_batch_threads(size_t threads);
+        // 开启后 compile 会尝试生成本机代码
+        void set_jit_enabled(bool enabled);
+        // evaluate(string) 与 evaluate_integer 共用的编译缓存（evaluate_decimal 另有一份同样容量的缓存）；
+        // 调试模式下不使用缓存，以便每次都打印词法和逆波兰结果。
+        // 开启空白规范化后，只有空白不同的表达式共用一份编译结果（错误位置以首次编译的文本为准）
+        void set_cache_capacity(size_t capacity);
+        void set_cache_normalize_whitespace(bool enabled);
+        CacheStats cache_stats() const;
+        // 编译时的常量折叠与代数化简，默认只做不改变结果的变换
+        void set_optimizer_options(const OptimizerOptions& options);
+        void set_front_end(FrontEnd front_end);
 
     private:
         SymbolTable symbols_;
         Logger logger_;
+        bool jit_enabled_;
+        OptimizerOptions optimizer_options_;
+        FrontEnd front_end_;
+#if defined(EXPRCALC_HAS_INT128)
+        DecimalArithmetic decimal_;
+#endif
+        Ast ast_; // 复用的语法树 arena
+        ExpressionCache cache_;
+#if defined(EXPRCALC_HAS_INT128)
+        ExpressionCache decimal_cache_; // evaluate_decimal 的 compile_exact 结果，常量池按当前十进制选项转换
+#endif
+        bool normalize_whitespace_;
+        std::string cache_key_; // 复用的规范化缓冲区
+        std::shared_ptr<ThreadPool> pool_;
+        CompiledExpression parse(std::string_view expression);
+        CompiledExpression compile_with(std::string_view expression, const OptimizerOptions& options);
+        template <typename Compile, typename Evaluate>
+        auto with_compiled(ExpressionCache& cache, std::string_view expression, Compile&& compile, Evaluate&& evaluate);
+        template <typename Evaluate>
+        auto with_compiled(std::string_view expression, Evaluate&& evaluate);
+        void clear_caches();
+        CompiledExpression compile_rpn(const std::vector<Token>& tokens);
+        CompiledExpression compile_ast(const std::vector<Token>& tokens);
     };
 
 } // namespace exprcalc
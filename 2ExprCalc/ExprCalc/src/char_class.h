@@ -0,0 +1,77 @@
+#ifndef EXPRCALC_CHAR_CLASS_H
+#define EXPRCALC_CHAR_CLASS_H
+
+#include "operators.h"
+#include <array>
+#include <cstdint>
+
+namespace exprcalc {
+
+    // 字符类别位，一个字节可以同时属于多个类别
+    enum CharClassBits : std::uint8_t {
+        CHAR_SPACE = 1 << 0,       // ' '、'\t'、'\n'、'\v'、'\f'、'\r'
+        CHAR_DIGIT = 1 << 1,       // '0'..'9'
+        CHAR_ALPHA = 1 << 2,       // ASCII 字母
+        CHAR_HEX_DIGIT = 1 << 3,   // 0-9、a-f、A-F
+        CHAR_NUMBER_PART = 1 << 4, // 十进制尾数中除数字外允许的 '.' 和 '_'
+    };
+
+    // 标记的首字符决定了它的种类，词法分析器据此一次分派
+    enum class TokenStart : std::uint8_t {
+        INVALID,
+        SPACE,
+        NUMBER,
+        IDENTIFIER,
+        OPERATOR,
+        LEFT_PAREN,
+        RIGHT_PAREN
+    };
+
+    struct CharInfo {
+        std::uint8_t classes;
+        TokenStart start;
+    };
+
+    namespace detail {
+        // 只看 ASCII，不依赖 locale；128 以上的字节不属于任何类别
+        constexpr std::array<CharInfo, 256> make_char_table() {
+            std::array<CharInfo, 256> table{};
+            for (int c = 0; c < 256; ++c) {
+                std::uint8_t classes = 0;
+                if (c == ' ' || (c >= '\t' && c <= '\r')) classes |= CHAR_SPACE;
+                if (c >= '0' && c <= '9') classes |= CHAR_DIGIT | CHAR_HEX_DIGIT;
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) classes |= CHAR_ALPHA;
+                if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) classes |= CHAR_HEX_DIGIT;
+                if (c == '.' || c == '_') classes |= CHAR_NUMBER_PART;
+
+                TokenStart start = TokenStart::INVALID;
+                if (classes & CHAR_SPACE) start = TokenStart::SPACE;
+                else if ((classes & CHAR_DIGIT) || c == '.') start = TokenStart::NUMBER;
+                else if (classes & CHAR_ALPHA) start = TokenStart::IDENTIFIER;
+                else if (detail::kOperatorIndex[c] != 0) start = TokenStart::OPERATOR;
+                else if (c == '(') start = TokenStart::LEFT_PAREN;
+                else if (c == ')') start = TokenStart::RIGHT_PAREN;
+                table[c] = {classes, start};
+            }
+            return table;
+        }
+        inline constexpr std::array<CharInfo, 256> kCharTable = make_char_table();
+    }
+
+    constexpr const CharInfo& char_info(char c) {
+        return detail::kCharTable[static_cast<unsigned char>(c)];
+    }
+
+    constexpr bool has_class(char c, std::uint8_t classes) {
+        return (char_info(c).classes & classes) != 0;
+    }
+
+    constexpr bool is_space(char c) { return has_class(c, CHAR_SPACE); }
+    constexpr bool is_digit(char c) { return has_class(c, CHAR_DIGIT); }
+    constexpr bool is_alpha(char c) { return has_class(c, CHAR_ALPHA); }
+    constexpr bool is_alnum(char c) { return has_class(c, CHAR_ALPHA | CHAR_DIGIT); }
+    constexpr bool is_hex_digit(char c) { return has_class(c, CHAR_HEX_DIGIT); }
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_CHAR_CLASS_H
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "compiled_expression.h"
+#include "evaluator.h"
+#include "jit.h"
+#include "error.h"
+#include "lexer.h"
+#include "stack_buffer.h"
+#include <charconv>
+#include <cmath>
+
+namespace exprcalc {
+
+    namespace {
+        // 第 pc 条 PUSH_CONST 指令对应的十进制字面量文本（去掉数字分隔符），取不到时返回空串。
+        // 常量指令记录的是字面量的起始位置；优化器生成的常量（如 x*0 的 0）位置上不是这个数字，十六进制字面量也不处理
+        std::string literal_text(const Bytecode& bytecode, size_t pc, std::string_view source) {
+            const size_t position = bytecode.positions[pc];
+            if (position >= source.size()) return {};
+            const Token token = Lexer(source.substr(position)).next();
+            const bool hex = token.value.size() > 1 && (token.value[1] | 0x20) == 'x';
+            if (token.type != TokenType::NUMBER || token.number != bytecode.constants[bytecode.code[pc].operand] || hex) {
+                return {};
+            }
+            std::string literal;
+            for (char c : token.value) {
+                if (c != '_') literal.push_back(c);
+            }
+            return literal;
+        }
+
+        // 绝对值不小于 2^53 的常量可能已被词法分析舍入，没有字面量可核对时不当作精确整数
+        IntegerValue integer_constant(double value) {
+            if (std::abs(value) >= 0x1p53) return IntegerValue::of_real(value);
+            return IntegerArithmetic::from_double(value);
+        }
+    }
+
+    CompiledExpression::CompiledExpression(const std::vector<Token>& rpn)
+        : bytecode_(BytecodeCompiler(rpn).compile()), bound_table_(0) {
+        convert_constants();
+    }
+
+    CompiledExpression::CompiledExpression(Bytecode bytecode)
+        : bytecode_(std::move(bytecode)), bound_table_(0) {
+        convert_constants();
+    }
+
+    OptimizationStats CompiledExpression::optimize(const OptimizerOptions& options) {
+        OptimizationStats stats = BytecodeOptimizer(options).optimize(bytecode_);
+        jit_.reset();
+        bound_refs_.clear();
+        bound_table_ = 0;
+        convert_constants();
+        return stats;
+    }
+
+    void CompiledExpression::convert_constants() {
+        integer_constants_.clear();
+        integer_constants_.reserve(bytecode_.constants.size());
+        for (double constant : bytecode_.constants) {
+            integer_constants_.push_back(integer_constant(constant));
+        }
+        update_int64_constants();
+#if defined(EXPRCALC_HAS_INT128)
+        decimal_literals_.clear(); // 字节码变了，常量下标不再对应原来的字面量
+        decimal_constants_.clear();
+        decimal_options_.reset();
+#endif
+    }
+
+    void CompiledExpression::prepare_integer(std::string_view source) {
+        // 公共子表达式消除按 double 比较常量，可能已把只在 2^53 以上才不同的字面量合并成一个，这时无法核对
+        if (bytecode_.temp_count != 0) return;
+        for (size_t pc = 0; pc < bytecode_.code.size(); ++pc) {
+            const Instruction instruction = bytecode_.code[pc];
+            if (instruction.op != OpCode::PUSH_CONST || std::abs(bytecode_.constants[instruction.operand]) < 0x1p53) {
+                continue;
+            }
+            const std::string literal = literal_text(bytecode_, pc, source);
+            std::int64_t value = 0;
+            auto [end, ec] = std::from_chars(literal.data(), literal.data() + literal.size(), value);
+            if (!literal.empty() && ec == std::errc() && end == literal.data() + literal.size()) {
+                integer_constants_[instruction.operand] = IntegerValue::of(value);
+            }
+        }
+        update_int64_constants();
+    }
+
+    void CompiledExpression::update_int64_constants() {
+        int64_constants_.clear();
+        int64_constants_exact_ = true;
+        for (const IntegerValue& constant : integer_constants_) {
+            if (!constant.is_integer) {
+                int64_constants_exact_ = false;
+                int64_constants_.clear();
+                return;
+            }
+            int64_constants_.push_back(constant.integer);
+        }
+    }
+
+    IntegerValue CompiledExpression::evaluate_integer(const double* slots) const {
+        // 常量和变量都是整数时先用纯 int64 计算；中途溢出或除不尽就整段改用带标记的 IntegerArithmetic 重算，
+        // 求值没有副作用，除零等错误在两条路径上出现的位置也相同
+        if (int64_constants_exact_) {
+            StackBuffer<std::int64_t, detail::kInlineValueCount> values(bytecode_.variables.size());
+            try {
+                for (size_t i = 0; i < bytecode_.variables.size(); ++i) {
+                    values[i] = Int64Arithmetic::from_double(slots[i]);
+                }
+                return IntegerValue::of(interpret<Int64Arithmetic>(bytecode_, int64_constants_.data(), values.data()));
+            } catch (const IntegerPromotion&) {
+            }
+        }
+        return interpret_converted<IntegerArithmetic>(bytecode_, integer_constants_.data(), slots);
+    }
+
+#if defined(EXPRCALC_HAS_INT128)
+    void CompiledExpression::prepare_decimal(std::string_view source, const DecimalArithmetic& arithmetic) {
+        decimal_literals_.assign(bytecode_.constants.size(), std::string());
+        for (size_t pc = 0; pc < bytecode_.code.size(); ++pc) {
+            if (bytecode_.code[pc].op == OpCode::PUSH_CONST) {
+                decimal_literals_[bytecode_.code[pc].operand] = literal_text(bytecode_, pc, source);
+            }
+        }
+        decimal_constants_.clear();
+        decimal_constants_.reserve(bytecode_.constants.size());
+        for (size_t i = 0; i < bytecode_.constants.size(); ++i) {
+            try {
+                decimal_constants_.push_back(convert_constant(arithmetic, i));
+            } catch (const ArithmeticOverflow&) {
+                decimal_constants_.clear();
+                return; // 求值时再按同样的方式转换并报告溢出
+            }
+        }
+        decimal_options_ = arithmetic.options();
+    }
+
+    Int128 CompiledExpression::convert_constant(const DecimalArithmetic& arithmetic, size_t index) const {
+        if (index < decimal_literals_.size() && !decimal_literals_[index].empty()) {
+            return arithmetic.parse(decimal_literals_[index]);
+        }
+        return arithmetic.from_double(bytecode_.constants[index]);
+    }
+#endif
+
+    void CompiledExpression::bind(SymbolTable& symbols) {
+        bound_refs_.clear();
+        for (const auto& name : bytecode_.variables) {
+            bound_refs_.push_back(symbols.intern(name));
+        }
+        bound_table_ = symbols.id();
+    }
+
+    double CompiledExpression::evaluate(const SymbolTable& symbols) const {
+        StackBuffer<double, Evaluator::kInlineSlotCount> slots(bytecode_.variables.size());
+        load_slots(symbols, slots.data());
+        return execute(slots.data());
+    }
+
+    void CompiledExpression::load_slots(const SymbolTable& symbols, double* slots) const {
+        const auto& variables = bytecode_.variables;
+        if (symbols.id() == bound_table_) {
+            for (size_t i = 0; i < variables.size(); ++i) {
+                slots[i] = symbols.get(bound_refs_[i]);
+            }
+        } else {
+            for (size_t i = 0; i < variables.size(); ++i) {
+                slots[i] = symbols.get_variable(variables[i]);
+            }
+        }
+    }
+
+    double CompiledExpression::evaluate(const std::map<std::string, double>& bindings) const {
+        const auto& variables = bytecode_.variables;
+        StackBuffer<double, Evaluator::kInlineSlotCount> slots(variables.size());
+        for (size_t i = 0; i < variables.size(); ++i) {
+            auto it = bindings.find(variables[i]);
+            if (it == bindings.end()) {
+                throw CalculationError("Undefined variable: " + variables[i], 0);
+            }
+            slots[i] = it->second;
+        }
+        return execute(slots.data());
+    }
+
+    double CompiledExpression::execute(const double* slots) const {
+        if (jit_) return jit_->evaluate(slots);
+        return Evaluator::execute(bytecode_, slots);
+    }
+
+    void CompiledExpression::evaluate_batch(const ColumnMap& columns, std::span<double> out,
+                                            const SymbolTable* scalars, ThreadPool* pool) const {
+        BatchEvaluator evaluator(bytecode_, columns, scalars);
+        if (pool != nullptr) {
+            evaluator.evaluate_parallel(out, *pool);
+        } else {
+            evaluator.evaluate(out);
+        }
+    }
+
+    bool CompiledExpression::enable_jit() {
+        if (!jit_) jit_ = JitFunction::compile(bytecode_);
+        return jit_enabled();
+    }
+
+    bool CompiledExpression::jit_enabled() const {
+        return jit_ != nullptr;
+    }
+
+    const Bytecode& CompiledExpression::bytecode() const {
+        return bytecode_;
+    }
+
+} // namespace exprcalc
\ No newline at end of file
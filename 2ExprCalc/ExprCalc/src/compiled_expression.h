@@ -0,0 +1,121 @@
+#ifndef EXPRCALC_COMPILED_EXPRESSION_H
+#define EXPRCALC_COMPILED_EXPRESSION_H
+
+#include "batch_evaluator.h"
+#include "bytecode.h"
+#include "decimal.h"
+#include "interpreter.h"
+#include "jit.h"
+#include "optimizer.h"
+#include "thread_pool.h"
+#include "token.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace exprcalc {
+
+    // 预编译表达式：词法分析和逆波兰转换只做一次，之后可反复求值
+    class CompiledExpression {
+    public:
+        explicit CompiledExpression(const std::vector<Token>& rpn);
+        explicit CompiledExpression(Bytecode bytecode);
+        // 化简字节码；会丢弃已有的绑定和本机代码，应在 bind / enable_jit 之前调用
+        OptimizationStats optimize(const OptimizerOptions& options = {});
+        // 把变量登记到 symbols 中并记住各自的槽位；之后对同一张表求值时不再按名字查找
+        void bind(SymbolTable& symbols);
+        double evaluate(const SymbolTable& symbols) const;
+        double evaluate(const std::map<std::string, double>& bindings) const;
+        // 用指定的数值后端解释执行（不使用本机代码）。double 和整数后端的常量池在编译时转换好，
+        // 整数后端在常量和变量都是整数时先走不带标记的 int64 快速路径；
+        // 十进制后端的常量池由 prepare_decimal 生成；其他情况下的常量以及所有变量值在每次求值时转换
+        template <typename Arithmetic>
+        typename Arithmetic::value_type evaluate_as(const SymbolTable& symbols, const Arithmetic& arithmetic = {}) const;
+        // 绝对值不小于 2^53 的常量在 double 中可能已经舍入，整数模式默认按非整数处理；
+        // 这里按 source（编译所用的文本）中的字面量重新读取能精确表示的整数
+        void prepare_integer(std::string_view source);
+#if defined(EXPRCALC_HAS_INT128)
+        // 按 source（编译所用的文本）中的字面量文本把常量精确转换为十进制并缓存，不经过 double；
+        // 之后用相同选项的 DecimalArithmetic 求值时直接使用，选项不同时按字面量文本重新转换
+        void prepare_decimal(std::string_view source, const DecimalArithmetic& arithmetic);
+#endif
+        // pool 不为空时按行区间并行计算
+        void evaluate_batch(const ColumnMap& columns, std::span<double> out,
+                            const SymbolTable* scalars = nullptr, ThreadPool* pool = nullptr) const;
+        // 尝试编译成本机代码，平台不支持时返回 false 并继续使用解释器
+        bool enable_jit();
+        bool jit_enabled() const;
+        // 热路径：在已解析好的变量槽位上求值
+        double execute(const double* slots) const;
+        const Bytecode& bytecode() const;
+
+    private:
+        Bytecode bytecode_;
+        std::shared_ptr<const JitFunction> jit_;
+        std::uint64_t bound_table_;
+        std::vector<VariableRef> bound_refs_; // 字节码变量槽位 -> 绑定表中的句柄
+        std::vector<IntegerValue> integer_constants_; // 整数模式的常量池，随字节码一起更新
+        std::vector<std::int64_t> int64_constants_;   // 常量全是精确整数时供 int64 快速路径使用
+        bool int64_constants_exact_ = false;
+#if defined(EXPRCALC_HAS_INT128)
+        std::vector<std::string> decimal_literals_; // 常量的十进制字面量文本，空串表示没有（改用 double 值）
+        std::vector<Int128> decimal_constants_;
+        std::optional<DecimalOptions> decimal_options_; // decimal_constants_ 转换时使用的选项
+#endif
+        void load_slots(const SymbolTable& symbols, double* slots) const;
+        void convert_constants();
+        void update_int64_constants();
+        IntegerValue evaluate_integer(const double* slots) const;
+
+        // 没有缓存的常量池时逐个转换第 index 个常量
+        template <typename Arithmetic>
+        typename Arithmetic::value_type convert_constant(const Arithmetic& arithmetic, size_t index) const {
+            return arithmetic.from_double(bytecode_.constants[index]);
+        }
+
+        // 已按后端转换好的常量池，没有时返回空指针
+        const double* cached_constants(const DoubleArithmetic&) const { return bytecode_.constants.data(); }
+        const IntegerValue* cached_constants(const IntegerArithmetic&) const { return integer_constants_.data(); }
+        template <typename Arithmetic>
+        const typename Arithmetic::value_type* cached_constants(const Arithmetic&) const { return nullptr; }
+#if defined(EXPRCALC_HAS_INT128)
+        Int128 convert_constant(const DecimalArithmetic& arithmetic, size_t index) const;
+        const Int128* cached_constants(const DecimalArithmetic& arithmetic) const {
+            return decimal_options_ == arithmetic.options() ? decimal_constants_.data() : nullptr;
+        }
+#endif
+    };
+
+    template <typename Arithmetic>
+    typename Arithmetic::value_type CompiledExpression::evaluate_as(const SymbolTable& symbols,
+                                                                    const Arithmetic& arithmetic) const {
+        using Value = typename Arithmetic::value_type;
+        StackBuffer<double, detail::kInlineValueCount> slots(bytecode_.variables.size());
+        load_slots(symbols, slots.data());
+        if constexpr (std::is_same_v<Arithmetic, IntegerArithmetic>) {
+            return evaluate_integer(slots.data());
+        }
+        const Value* constants = cached_constants(arithmetic);
+        StackBuffer<Value, detail::kInlineValueCount> converted(constants ? 0 : bytecode_.constants.size());
+        if (!constants) {
+            try {
+                for (size_t i = 0; i < bytecode_.constants.size(); ++i) {
+                    converted[i] = convert_constant(arithmetic, i);
+                }
+            } catch (const ArithmeticOverflow&) {
+                throw CalculationError("Numeric overflow", 0); // 常量超出后端的表示范围
+            }
+            constants = converted.data();
+        }
+        return interpret_converted(bytecode_, constants, slots.data(), arithmetic);
+    }
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_COMPILED_EXPRESSION_H
\ No newline at end of file
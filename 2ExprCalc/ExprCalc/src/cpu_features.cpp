@@ -0,0 +1,75 @@
+#include "cpu_features.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#if defined(EXPRCALC_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace exprcalc {
+
+    namespace {
+
+        SimdLevel query_simd_level() {
+#if defined(EXPRCALC_X86) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+            return SimdLevel::SCALAR;
+#elif defined(EXPRCALC_X86) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int max_leaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || max_leaf < 7) return sse2 ? SimdLevel::SSE2 : SimdLevel::SCALAR;
+            // 操作系统必须保存 YMM/ZMM 寄存器状态，否则即使 CPU 支持也不能使用
+            const unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            const bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+            const bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+            if (avx512) return SimdLevel::AVX512;
+            if (avx2) return SimdLevel::AVX2;
+            return sse2 ? SimdLevel::SSE2 : SimdLevel::SCALAR;
+#else
+            return SimdLevel::SCALAR;
+#endif
+        }
+
+        constexpr size_t kDefaultL2CacheSize = 256 * 1024;
+
+    } // namespace
+
+    SimdLevel detect_simd_level() {
+        static const SimdLevel level = query_simd_level();
+        return level;
+    }
+
+    const char* simd_level_name(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SCALAR: return "scalar";
+            case SimdLevel::SSE2: return "sse2";
+            case SimdLevel::AVX2: return "avx2";
+            case SimdLevel::AVX512: return "avx512";
+        }
+        return "unknown";
+    }
+
+    size_t l2_cache_size() {
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+        static const size_t size = [] {
+            long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            return bytes > 0 ? static_cast<size_t>(bytes) : kDefaultL2CacheSize;
+        }();
+        return size;
+#else
+        return kDefaultL2CacheSize;
+#endif
+    }
+
+} // namespace exprcalc
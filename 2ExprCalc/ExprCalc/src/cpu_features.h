@@ -0,0 +1,32 @@
+#ifndef EXPRCALC_CPU_FEATURES_H
+#define EXPRCALC_CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define EXPRCALC_X86 1
+#endif
+
+// 单个函数级别的指令集开关，使同一个二进制文件可以包含多套内核
+#if defined(__GNUC__) || defined(__clang__)
+#define EXPRCALC_TARGET(isa) __attribute__((target(isa)))
+#else
+#define EXPRCALC_TARGET(isa)
+#endif
+
+#include <cstddef>
+
+namespace exprcalc {
+
+    enum class SimdLevel {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    SimdLevel detect_simd_level(); // 运行时通过 CPUID 检测，结果会被缓存
+    const char* simd_level_name(SimdLevel level);
+    size_t l2_cache_size(); // 单核 L2 缓存大小（字节），查询不到时返回保守的默认值
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_CPU_FEATURES_H
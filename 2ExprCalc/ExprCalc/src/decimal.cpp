@@ -0,0 +1,201 @@
+#include "decimal.h"
+
+#if defined(EXPRCALC_HAS_INT128)
+
+#include "char_class.h"
+#include "error.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+
+namespace exprcalc {
+
+    namespace {
+
+        constexpr std::array<UInt128, 39> make_powers_of_ten() {
+            std::array<UInt128, 39> powers{};
+            powers[0] = 1;
+            for (size_t i = 1; i < powers.size(); ++i) powers[i] = powers[i - 1] * 10;
+            return powers;
+        }
+        constexpr std::array<UInt128, 39> kPowersOfTen = make_powers_of_ten();
+
+        constexpr UInt128 kInt128Max = (UInt128{1} << 127) - 1;
+
+        // 256 位无符号数，只用于乘除的慢路径
+        struct UInt256 {
+            UInt128 high;
+            UInt128 low;
+        };
+
+        UInt256 multiply(UInt128 a, UInt128 b) {
+            const UInt128 a0 = static_cast<std::uint64_t>(a), a1 = a >> 64;
+            const UInt128 b0 = static_cast<std::uint64_t>(b), b1 = b >> 64;
+            const UInt128 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+            const UInt128 middle = (p00 >> 64) + static_cast<std::uint64_t>(p01) + static_cast<std::uint64_t>(p10);
+            return {p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64),
+                    (middle << 64) | static_cast<std::uint64_t>(p00)};
+        }
+
+        // 逐位长除法，divisor 不为 0
+        UInt256 divide(UInt256 dividend, UInt128 divisor, UInt128& remainder) {
+            UInt256 quotient{0, 0};
+            remainder = 0;
+            for (int bit = 255; bit >= 0; --bit) {
+                const bool carry = (remainder >> 127) != 0;
+                const UInt128 next = bit >= 128 ? dividend.high >> (bit - 128) : dividend.low >> bit;
+                remainder = (remainder << 1) | (next & 1);
+                // carry 时真实余数为 2^128 + remainder，一定不小于除数，回绕相减的结果正确
+                if (carry || remainder >= divisor) {
+                    remainder -= divisor;
+                    if (bit >= 128) {
+                        quotient.high |= UInt128{1} << (bit - 128);
+                    } else {
+                        quotient.low |= UInt128{1} << bit;
+                    }
+                }
+            }
+            return quotient;
+        }
+
+        Int128 with_sign(UInt128 magnitude, bool negative) {
+            if (magnitude > kInt128Max) throw ArithmeticOverflow{};
+            const Int128 value = static_cast<Int128>(magnitude);
+            return negative ? -value : value;
+        }
+
+        int compare_half(UInt128 remainder, UInt128 divisor) {
+            const UInt128 twice = remainder * 2; // 余数小于除数（不超过 2^127）
+            return twice < divisor ? -1 : (twice == divisor ? 0 : 1);
+        }
+
+    } // namespace
+
+    std::string Decimal::to_string() const {
+        const bool negative = units < 0;
+        UInt128 magnitude = negative ? UInt128{0} - static_cast<UInt128>(units) : static_cast<UInt128>(units);
+        std::string digits;
+        do {
+            digits.push_back(static_cast<char>('0' + static_cast<int>(magnitude % 10)));
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (digits.size() <= scale) digits.resize(scale + 1, '0');
+
+        std::string text = negative ? "-" : "";
+        for (size_t i = digits.size(); i-- > 0;) {
+            text.push_back(digits[i]);
+            if (i == scale && scale > 0) text.push_back('.');
+        }
+        return text;
+    }
+
+    double Decimal::to_double() const {
+        const std::string text = to_string();
+        double value = 0.0;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    DecimalArithmetic::DecimalArithmetic(const DecimalOptions& options) : options_(options), factor_(0) {
+        if (options.scale > kMaxDecimalScale) {
+            throw CalculationError("Decimal scale must be at most " + std::to_string(kMaxDecimalScale), 0);
+        }
+        factor_ = static_cast<Int128>(kPowersOfTen[options.scale]);
+    }
+
+    Int128 DecimalArithmetic::from_double(double value) const {
+        if (!std::isfinite(value)) throw ArithmeticOverflow{};
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return parse(std::string_view(buffer, static_cast<size_t>(end - buffer)));
+    }
+
+    Int128 DecimalArithmetic::parse(std::string_view text) const {
+        size_t i = 0;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '+' || text[i] == '-')) negative = text[i++] == '-';
+
+        UInt128 digits = 0;
+        long exponent = 0;
+        bool any_digit = false;
+        bool fraction = false;
+        for (; i < text.size(); ++i) {
+            const char c = text[i];
+            if (c == '.' && !fraction) {
+                fraction = true;
+                continue;
+            }
+            if (!is_digit(c)) break;
+            if (digits > (~UInt128{0} - 9) / 10) throw ArithmeticOverflow{};
+            digits = digits * 10 + static_cast<unsigned>(c - '0');
+            if (fraction) --exponent;
+            any_digit = true;
+        }
+        if (any_digit && i < text.size() && (text[i] | 0x20) == 'e') {
+            int power = 0;
+            const char* begin = text.data() + i + 1 + (i + 1 < text.size() && text[i + 1] == '+');
+            auto [end, ec] = std::from_chars(begin, text.data() + text.size(), power);
+            if (ec == std::errc::result_out_of_range) throw ArithmeticOverflow{};
+            if (ec == std::errc()) {
+                exponent += power;
+                i = static_cast<size_t>(end - text.data());
+            }
+        }
+        if (!any_digit || i != text.size()) {
+            throw CalculationError("Invalid decimal: " + std::string(text), 0);
+        }
+
+        const long shift = exponent + static_cast<long>(options_.scale);
+        if (shift >= 0) {
+            if (digits == 0) return 0;
+            if (shift >= static_cast<long>(kPowersOfTen.size()) || digits > kInt128Max / kPowersOfTen[shift]) {
+                throw ArithmeticOverflow{};
+            }
+            return with_sign(digits * kPowersOfTen[shift], negative);
+        }
+        // 小数位多于 scale：截断后按舍入模式处理
+        if (-shift >= static_cast<long>(kPowersOfTen.size())) {
+            return digits == 0 ? 0 : round_away(0, negative, -1);
+        }
+        const UInt128 divisor = kPowersOfTen[-shift];
+        const UInt128 remainder = digits % divisor;
+        const Int128 quotient = with_sign(digits / divisor, negative);
+        return remainder == 0 ? quotient : round_away(quotient, negative, compare_half(remainder, divisor));
+    }
+
+    Int128 DecimalArithmetic::round_away(Int128 quotient, bool negative, int half) const {
+        bool away = false;
+        switch (options_.rounding) {
+            case RoundingMode::HALF_EVEN: away = half > 0 || (half == 0 && (quotient & 1) != 0); break;
+            case RoundingMode::HALF_UP: away = half >= 0; break;
+            case RoundingMode::DOWN: away = false; break;
+            case RoundingMode::FLOOR: away = negative; break;
+            case RoundingMode::CEILING: away = !negative; break;
+        }
+        if (!away) return quotient;
+        return negative ? sub(quotient, 1) : add(quotient, 1);
+    }
+
+    Int128 DecimalArithmetic::mul_wide(Int128 lhs, Int128 rhs) const {
+        const bool negative = (lhs < 0) != (rhs < 0);
+        UInt128 remainder = 0;
+        const UInt256 quotient = divide(multiply(magnitude(lhs), magnitude(rhs)), static_cast<UInt128>(factor_), remainder);
+        if (quotient.high != 0) throw ArithmeticOverflow{};
+        const Int128 result = with_sign(quotient.low, negative);
+        return remainder == 0 ? result
+                              : round_away(result, negative, compare_half(remainder, static_cast<UInt128>(factor_)));
+    }
+
+    Int128 DecimalArithmetic::div_wide(Int128 lhs, Int128 rhs) const {
+        const bool negative = (lhs < 0) != (rhs < 0);
+        const UInt128 divisor = magnitude(rhs);
+        UInt128 remainder = 0;
+        const UInt256 quotient = divide(multiply(magnitude(lhs), static_cast<UInt128>(factor_)), divisor, remainder);
+        if (quotient.high != 0) throw ArithmeticOverflow{};
+        const Int128 result = with_sign(quotient.low, negative);
+        return remainder == 0 ? result : round_away(result, negative, compare_half(remainder, divisor));
+    }
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_HAS_INT128
\ No newline at end of file
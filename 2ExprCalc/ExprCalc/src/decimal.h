@@ -0,0 +1,121 @@
+#ifndef EXPRCALC_DECIMAL_H
+#define EXPRCALC_DECIMAL_H
+
+#include "numeric.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 十进制模式依赖编译器提供的 128 位整数（GCC、Clang）
+#if defined(__SIZEOF_INT128__)
+#define EXPRCALC_HAS_INT128 1
+#endif
+
+#if defined(EXPRCALC_HAS_INT128)
+
+namespace exprcalc {
+
+    // __extension__ 让 -Wpedantic 不对非标准的 __int128 报警
+    __extension__ typedef __int128 Int128;
+    __extension__ typedef unsigned __int128 UInt128;
+
+    enum class RoundingMode : std::uint8_t {
+        HALF_EVEN, // 恰好一半时取偶数（银行家舍入）
+        HALF_UP,   // 恰好一半时远离 0
+        DOWN,      // 截断，向 0 舍入
+        FLOOR,     // 向负无穷舍入
+        CEILING    // 向正无穷舍入
+    };
+
+    inline constexpr unsigned kMaxDecimalScale = 18; // 10^scale 不超过 64 位
+
+    struct DecimalOptions {
+        unsigned scale = 4; // 小数位数
+        RoundingMode rounding = RoundingMode::HALF_EVEN;
+
+        bool operator==(const DecimalOptions&) const = default;
+    };
+
+    // 定点十进制数，值为 units / 10^scale
+    struct Decimal {
+        Int128 units;
+        unsigned scale;
+
+        std::string to_string() const; // 总是输出 scale 位小数，如 "-12.3400"
+        double to_double() const;      // 最接近的 double
+    };
+
+    // 128 位定点十进制后端（接口约定见 numeric.h）。所有值共用同一个小数位数：
+    // 加减精确，乘除结果按舍入模式舍入到 scale 位，超出 128 位时抛出 ArithmeticOverflow
+    class DecimalArithmetic {
+    public:
+        using value_type = Int128;
+        static constexpr bool may_overflow = true;
+
+        explicit DecimalArithmetic(const DecimalOptions& options = {});
+        const DecimalOptions& options() const { return options_; }
+
+        // 按 double 的最短十进制表示转换（0.1 得到 0.1000），而不是按它的二进制值
+        Int128 from_double(double value) const;
+        // 解析十进制文本，可带符号和指数（如 "-1.25e3"），按舍入模式舍入到 scale 位
+        Int128 parse(std::string_view text) const;
+        Decimal to_decimal(Int128 units) const { return {units, options_.scale}; }
+
+        static Int128 add(Int128 lhs, Int128 rhs) {
+            Int128 result;
+            if (__builtin_add_overflow(lhs, rhs, &result)) throw ArithmeticOverflow{};
+            return result;
+        }
+
+        static Int128 sub(Int128 lhs, Int128 rhs) {
+            Int128 result;
+            if (__builtin_sub_overflow(lhs, rhs, &result)) throw ArithmeticOverflow{};
+            return result;
+        }
+
+        // 乘积还在 128 位以内时直接除以 10^scale，否则走 256 位的慢路径
+        Int128 mul(Int128 lhs, Int128 rhs) const {
+            Int128 product;
+            if (!__builtin_mul_overflow(lhs, rhs, &product)) {
+                return round_quotient(product / factor_, product % factor_, factor_, product < 0);
+            }
+            return mul_wide(lhs, rhs);
+        }
+
+        Int128 div(Int128 lhs, Int128 rhs) const {
+            Int128 dividend;
+            if (rhs != -1 && !__builtin_mul_overflow(lhs, factor_, &dividend)) {
+                return round_quotient(dividend / rhs, dividend % rhs, magnitude(rhs), (lhs < 0) != (rhs < 0));
+            }
+            return div_wide(lhs, rhs);
+        }
+
+        static Int128 neg(Int128 value) { return sub(0, value); }
+        static bool is_zero(Int128 value) { return value == 0; }
+
+    private:
+        DecimalOptions options_;
+        Int128 factor_; // 10^scale
+
+        static UInt128 magnitude(Int128 value) {
+            return value < 0 ? UInt128{0} - static_cast<UInt128>(value) : static_cast<UInt128>(value);
+        }
+
+        // quotient 是向 0 截断的商，remainder 是对应余数，divisor 是除数的绝对值；negative 为真实结果的符号
+        Int128 round_quotient(Int128 quotient, Int128 remainder, UInt128 divisor, bool negative) const {
+            if (remainder == 0) return quotient;
+            const UInt128 twice = magnitude(remainder) * 2; // 余数小于除数（不超过 2^127），不会溢出
+            return round_away(quotient, negative, twice < divisor ? -1 : (twice == divisor ? 0 : 1));
+        }
+
+        // 有非零余数时决定是否远离 0 进一位；half 为余数与半个除数比较的结果
+        Int128 round_away(Int128 quotient, bool negative, int half) const;
+        Int128 mul_wide(Int128 lhs, Int128 rhs) const;
+        Int128 div_wide(Int128 lhs, Int128 rhs) const;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_HAS_INT128
+
+#endif // EXPRCALC_DECIMAL_H
\ No newline at end of file
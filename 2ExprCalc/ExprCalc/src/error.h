@@ -16,6 +16,17 @@ namespace exprcalc {
         size_t position_;
     };
 
+    // 批量求值中的错误，额外记录出错的行号
+    class BatchError : public CalculationError {
+    public:
+        BatchError(const std::string& message, size_t position, size_t row)
+            : CalculationError(message, position), row_(row) {}
+        size_t get_row() const { return row_; }
+
+    private:
+        size_t row_;
+    };
+
 } // namespace exprcalc
 
 #endif // EXPRCALC_ERROR_H
\ No newline at end of file
@@ -1,55 +1,23 @@
 #include "evaluator.h"
-#include "error.h"
-#include <cmath>
+#include "interpreter.h"
+#include "stack_buffer.h"
 
 namespace exprcalc {
 
-    Evaluator::Evaluator(const std::vector<Token>& rpn, const SymbolTable& symbols)
-        : rpn_(rpn), symbols_(symbols) {}
+    Evaluator::Evaluator(const Bytecode& bytecode, const SymbolTable& symbols)
+        : bytecode_(bytecode), symbols_(symbols) {}
 
     double Evaluator::evaluate() {
-        std::stack<double> stack;
-
-        for (const auto& token : rpn_) {
-            switch (token.type) {
-                case TokenType::NUMBER:
-                    stack.push(std::stod(token.value));
-                    break;
-
-                case TokenType::VARIABLE:
-                    stack.push(symbols_.get_variable(token.value));
-                    break;
-
-                case TokenType::OPERATOR: {
-                    if (stack.size() < 2) {
-                        throw CalculationError("Insufficient operands for operator " + token.value, token.position);
-                    }
-                    double b = stack.top(); stack.pop();
-                    double a = stack.top(); stack.pop();
-                    stack.push(apply_operator(a, b, token.value));
-                    break;
-                }
-
-                default:
-                    throw CalculationError("Invalid token in RPN", token.position);
-            }
+        const auto& variables = bytecode_.variables;
+        StackBuffer<double, kInlineSlotCount> slots(variables.size());
+        for (size_t i = 0; i < variables.size(); ++i) {
+            slots[i] = symbols_.get_variable(variables[i]);
         }
-
-        if (stack.size() != 1) {
-            throw CalculationError("Invalid RPN expression: too many operands", 0);
-        }
-        return stack.top();
+        return execute(bytecode_, slots.data());
     }
 
-    double Evaluator::apply_operator(double a, double b, const std::string& op) const {
-        if (op == "+") return a + b;
-        if (op == "-") return a - b;
-        if (op == "*") return a * b;
-        if (op == "/") {
-            if (b == 0) throw CalculationError("Division by zero", 0);
-            return a / b;
-        }
-        throw CalculationError("Unknown operator: " + op, 0);
+    double Evaluator::execute(const Bytecode& bytecode, const double* slots) {
+        return interpret<DoubleArithmetic>(bytecode, bytecode.constants.data(), slots);
     }
 
 } // namespace exprcalc
\ No newline at end of file
@@ -1,24 +1,26 @@
 #ifndef EXPRCALC_EVALUATOR_H
 #define EXPRCALC_EVALUATOR_H
 
-#include "token.h"
+#include "bytecode.h"
 #include "symbol_table.h"
-#include <vector>
-#include <stack>
 
 namespace exprcalc {
 
     class Evaluator {
     public:
-        Evaluator(const std::vector<Token>& rpn, const SymbolTable& symbols);
+        static constexpr size_t kInlineSlotCount = 32; // 变量槽位不超过该值时不做堆分配
+
+        Evaluator(const Bytecode& bytecode, const SymbolTable& symbols);
         double evaluate();
 
+        // 热路径：在已解析好的变量槽位上执行字节码
+        static double execute(const Bytecode& bytecode, const double* slots);
+
     private:
-        const std::vector<Token>& rpn_;
+        const Bytecode& bytecode_;
         const SymbolTable& symbols_;
-        double apply_operator(double a, double b, const std::string& op) const;
     };
 
 } // namespace exprcalc
 
-#endif // EXPRCALC_EVALUATOR_H
\ No newline at end of file
+#endif // EXPRCALC_EVALUATOR_H
@@ -0,0 +1,119 @@
+#include "expr_generator.h"
+#include <algorithm>
+
+namespace exprcalc {
+
+    namespace {
+        constexpr char kOperatorSymbols[] = {'+', '-', '*', '/'};
+    }
+
+    ExpressionGenerator::ExpressionGenerator(const GeneratorOptions& options)
+        : options_(options), state_(options.seed), weight_total_(0) {
+        for (unsigned weight : options_.operator_weights) weight_total_ += weight;
+        if (weight_total_ == 0) {
+            options_.operator_weights = {1, 1, 1, 1};
+            weight_total_ = 4;
+        }
+        if (options_.terms == 0) options_.terms = 1;
+        // 变量取值用整数运算生成，避免依赖标准库分布的实现差异；保证非零
+        for (size_t i = 0; i < options_.variables; ++i) {
+            names_.push_back("v" + std::to_string(i));
+            values_.push_back(static_cast<double>(1 + next_below(9999)) / 100.0);
+        }
+    }
+
+    std::string ExpressionGenerator::next() {
+        std::string out;
+        append_next(out);
+        return out;
+    }
+
+    void ExpressionGenerator::append_next(std::string& out) {
+        append_expression(out, options_.terms, 0);
+    }
+
+    void ExpressionGenerator::write_bindings(std::ostream& out) const {
+        for (size_t i = 0; i < names_.size(); ++i) {
+            out << "set " << names_[i] << " = " << values_[i] << '\n';
+        }
+    }
+
+    const std::vector<std::string>& ExpressionGenerator::variable_names() const {
+        return names_;
+    }
+
+    const std::vector<double>& ExpressionGenerator::variable_values() const {
+        return values_;
+    }
+
+    void ExpressionGenerator::append_expression(std::string& out, size_t terms, size_t depth) {
+        size_t remaining = terms;
+        char op = 0;
+        while (remaining > 0) {
+            if (op != 0) {
+                out += ' ';
+                out += op;
+                out += ' ';
+            }
+            // 除号右边只放原子操作数；子表达式至少要有两个操作数才值得加括号
+            bool nest = op != '/' && depth < options_.max_depth && remaining >= 2 &&
+                        next_unit() < options_.paren_density;
+            if (nest) {
+                size_t inner = 2 + next_below(std::min<size_t>(remaining - 1, 4));
+                out += '(';
+                append_expression(out, inner, depth + 1);
+                out += ')';
+                remaining -= inner;
+            } else {
+                append_atom(out);
+                --remaining;
+            }
+            op = next_operator();
+        }
+    }
+
+    void ExpressionGenerator::append_atom(std::string& out) {
+        if (!names_.empty() && next_unit() < options_.variable_density) {
+            out += names_[next_below(names_.size())];
+        } else {
+            append_constant(out);
+        }
+    }
+
+    void ExpressionGenerator::append_constant(std::string& out) {
+        // 1 到 999，一半带两位小数；永远不为 0
+        out += std::to_string(1 + next_below(999));
+        if (next_below(2) == 0) {
+            size_t fraction = next_below(100);
+            out += '.';
+            out += static_cast<char>('0' + fraction / 10);
+            out += static_cast<char>('0' + fraction % 10);
+        }
+    }
+
+    char ExpressionGenerator::next_operator() {
+        size_t pick = next_below(weight_total_);
+        for (size_t i = 0; i < 4; ++i) {
+            if (pick < options_.operator_weights[i]) return kOperatorSymbols[i];
+            pick -= options_.operator_weights[i];
+        }
+        return '+';
+    }
+
+    // splitmix64：实现简单、跨平台结果一致
+    std::uint64_t ExpressionGenerator::next_random() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    double ExpressionGenerator::next_unit() {
+        return static_cast<double>(next_random() >> 11) * 0x1.0p-53;
+    }
+
+    size_t ExpressionGenerator::next_below(size_t bound) {
+        return static_cast<size_t>(next_random() % bound);
+    }
+
+} // namespace exprcalc
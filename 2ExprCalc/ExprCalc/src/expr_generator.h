@@ -0,0 +1,51 @@
+#ifndef EXPRCALC_EXPR_GENERATOR_H
+#define EXPRCALC_EXPR_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace exprcalc {
+
+    struct GeneratorOptions {
+        std::uint64_t seed = 1;
+        size_t terms = 16;                  // 每个表达式的操作数个数
+        size_t max_depth = 4;               // 括号最大嵌套深度
+        double paren_density = 0.2;         // 每个操作数位置展开成括号子表达式的概率
+        std::array<unsigned, 4> operator_weights{1, 1, 1, 1}; // + - * / 的相对权重
+        size_t variables = 4;               // 变量集合 v0..v{variables-1}，0 表示只用常量
+        double variable_density = 0.5;      // 操作数是变量（而不是常量）的概率
+    };
+
+    // 可复现的随机表达式生成器：相同的选项和种子在任何平台上都生成完全相同的序列。
+    // 生成的表达式总是合法的，且除号右边只会是非零常量或变量（变量绑定的值也非零），求值不会除零
+    class ExpressionGenerator {
+    public:
+        explicit ExpressionGenerator(const GeneratorOptions& options);
+        void append_next(std::string& out); // 追加一条表达式（不含换行），便于复用缓冲区流式输出
+        std::string next();
+        // 每个变量一行 "set v0 = 1.25"，可以直接作为 REPL 或批处理的输入
+        void write_bindings(std::ostream& out) const;
+        const std::vector<std::string>& variable_names() const;
+        const std::vector<double>& variable_values() const;
+
+    private:
+        GeneratorOptions options_;
+        std::uint64_t state_;
+        unsigned weight_total_;
+        std::vector<std::string> names_;
+        std::vector<double> values_;
+        std::uint64_t next_random();
+        double next_unit(); // [0, 1)
+        size_t next_below(size_t bound);
+        char next_operator();
+        void append_expression(std::string& out, size_t terms, size_t depth);
+        void append_atom(std::string& out);
+        void append_constant(std::string& out);
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_EXPR_GENERATOR_H
@@ -0,0 +1,124 @@
+#include "expression_cache.h"
+#include "char_class.h"
+
+namespace exprcalc {
+
+    namespace {
+        // 数字字面量和标识符可能包含的字符（含数字分隔符 '_'）
+        bool is_word_char(char c) {
+            return is_alnum(c) || c == '.' || c == '_';
+        }
+
+        bool is_exponent_mark(char c) {
+            return c == 'e' || c == 'E' || c == 'p' || c == 'P';
+        }
+
+        bool is_sign(char c) {
+            return c == '+' || c == '-';
+        }
+
+        // 去掉 out 与 next 之间的空白后，是否可能拼成一个不同的记号（如 "1 _0"、"2e -3"、"2e- 3"）
+        bool space_is_significant(const std::string& out, char next) {
+            const char last = out.back();
+            if (is_word_char(last) && is_word_char(next)) return true;
+            if (is_exponent_mark(last) && is_sign(next)) return true;
+            return is_sign(last) && out.size() >= 2 && is_exponent_mark(out[out.size() - 2]) && is_word_char(next);
+        }
+    }
+
+    ExpressionCache::ExpressionCache(size_t capacity)
+        : capacity_(capacity), hits_(0), misses_(0), evictions_(0) {}
+
+    ExpressionCache::ExpressionCache(const ExpressionCache& other)
+        : entries_(other.entries_), capacity_(other.capacity_), hits_(other.hits_), misses_(other.misses_), evictions_(other.evictions_) {
+        rebuild_index();
+    }
+
+    ExpressionCache& ExpressionCache::operator=(const ExpressionCache& other) {
+        if (this != &other) {
+            entries_ = other.entries_;
+            capacity_ = other.capacity_;
+            hits_ = other.hits_;
+            misses_ = other.misses_;
+            evictions_ = other.evictions_;
+            rebuild_index();
+        }
+        return *this;
+    }
+
+    std::shared_ptr<const CompiledExpression> ExpressionCache::find(std::string_view key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void ExpressionCache::insert(std::string_view key, std::shared_ptr<const CompiledExpression> compiled) {
+        if (capacity_ == 0) return;
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(compiled);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        evict_to(capacity_ - 1);
+        entries_.emplace_front(std::string(key), std::move(compiled));
+        index_.emplace(entries_.front().first, entries_.begin());
+    }
+
+    void ExpressionCache::set_capacity(size_t capacity) {
+        capacity_ = capacity;
+        evict_to(capacity_);
+    }
+
+    size_t ExpressionCache::capacity() const {
+        return capacity_;
+    }
+
+    void ExpressionCache::clear() {
+        index_.clear();
+        entries_.clear();
+    }
+
+    CacheStats ExpressionCache::stats() const {
+        return {hits_, misses_, evictions_, entries_.size(), capacity_};
+    }
+
+    void ExpressionCache::evict_to(size_t size) {
+        while (entries_.size() > size) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            ++evictions_;
+        }
+    }
+
+    void ExpressionCache::rebuild_index() {
+        index_.clear();
+        index_.reserve(entries_.size());
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            index_.emplace(it->first, it);
+        }
+    }
+
+    void ExpressionCache::normalize(std::string_view expression, std::string& out) {
+        out.clear();
+        bool pending_space = false;
+        for (char c : expression) {
+            if (is_space(c)) {
+                pending_space = true;
+                continue;
+            }
+            // "x y" 与 "xy" 含义不同；指数符号和数字分隔符两侧的空白也会改变字面量，必须保留
+            if (pending_space && !out.empty() && space_is_significant(out, c)) {
+                out.push_back(' ');
+            }
+            pending_space = false;
+            out.push_back(c);
+        }
+    }
+
+} // namespace exprcalc
\ No newline at end of file
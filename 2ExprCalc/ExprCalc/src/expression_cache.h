@@ -0,0 +1,57 @@
+#ifndef EXPRCALC_EXPRESSION_CACHE_H
+#define EXPRCALC_EXPRESSION_CACHE_H
+
+#include "compiled_expression.h"
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace exprcalc {
+
+    struct CacheStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    // 以表达式文本为键、容量有限的 LRU 缓存，命中时直接复用编译结果
+    class ExpressionCache {
+    public:
+        explicit ExpressionCache(size_t capacity);
+        // index_ 的键和迭代器指向本对象的 entries_，复制时必须按新链表重建
+        ExpressionCache(const ExpressionCache& other);
+        ExpressionCache& operator=(const ExpressionCache& other);
+        ExpressionCache(ExpressionCache&&) noexcept = default;
+        ExpressionCache& operator=(ExpressionCache&&) noexcept = default;
+
+        std::shared_ptr<const CompiledExpression> find(std::string_view key);
+        void insert(std::string_view key, std::shared_ptr<const CompiledExpression> compiled);
+        void set_capacity(size_t capacity); // 0 表示关闭缓存
+        size_t capacity() const;
+        void clear();
+        CacheStats stats() const;
+
+        // 去掉不影响含义的空白：只在去掉后可能拼成另一个标识符或数字字面量的位置保留一个空格，结果写入 out
+        static void normalize(std::string_view expression, std::string& out);
+
+    private:
+        using Entry = std::pair<std::string, std::shared_ptr<const CompiledExpression>>;
+
+        std::list<Entry> entries_; // 最近使用的在前
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index_; // 键指向链表节点中的字符串
+        size_t capacity_;
+        size_t hits_;
+        size_t misses_;
+        size_t evictions_;
+        void evict_to(size_t size);
+        void rebuild_index();
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_EXPRESSION_CACHE_H
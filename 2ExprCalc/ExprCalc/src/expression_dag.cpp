@@ -0,0 +1,140 @@
+#include "expression_dag.h"
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+namespace exprcalc {
+
+    namespace {
+        struct NodeKey {
+            OpCode op;
+            std::uint64_t a; // 常量的位模式、变量槽位或左子节点
+            std::uint64_t b; // 右子节点
+
+            bool operator==(const NodeKey& other) const {
+                return op == other.op && a == other.a && b == other.b;
+            }
+        };
+
+        struct NodeKeyHash {
+            size_t operator()(const NodeKey& key) const {
+                std::uint64_t h = key.a * 0x9E3779B97F4A7C15ULL;
+                h ^= (key.b + 0x7F4A7C15ULL + (h << 6) + (h >> 2)) * 0xBF58476D1CE4E5B9ULL;
+                h ^= static_cast<std::uint64_t>(key.op) << 56;
+                return static_cast<size_t>(h ^ (h >> 31));
+            }
+        };
+
+        constexpr auto kNoTemp = static_cast<std::uint32_t>(-1);
+
+        bool is_leaf(OpCode op) {
+            return op == OpCode::PUSH_CONST || op == OpCode::LOAD_VAR;
+        }
+    }
+
+    ExpressionDag::ExpressionDag(const Bytecode& bytecode) : root_(0) {
+        std::unordered_map<NodeKey, NodeId, NodeKeyHash> index;
+        std::vector<NodeId> stack;
+        nodes_.reserve(bytecode.code.size());
+        index.reserve(bytecode.code.size());
+
+        for (size_t pc = 0; pc < bytecode.code.size(); ++pc) {
+            const Instruction instruction = bytecode.code[pc];
+            NodeKey key{instruction.op, 0, 0};
+            NodeId lhs = 0, rhs = 0;
+            if (instruction.op == OpCode::PUSH_CONST) {
+                // 按数值而不是常量下标去重，相同字面量出现多次也能合并
+                std::memcpy(&key.a, &bytecode.constants[instruction.operand], sizeof(double));
+            } else if (instruction.op == OpCode::LOAD_VAR) {
+                key.a = instruction.operand;
+            } else if (instruction.op == OpCode::NEG) {
+                lhs = stack.back();
+                stack.pop_back();
+                key.a = lhs;
+            } else {
+                rhs = stack.back();
+                stack.pop_back();
+                lhs = stack.back();
+                stack.pop_back();
+                bool commutative = instruction.op == OpCode::ADD || instruction.op == OpCode::MUL;
+                key.a = commutative ? std::min(lhs, rhs) : lhs;
+                key.b = commutative ? std::max(lhs, rhs) : rhs;
+            }
+
+            auto [it, inserted] = index.try_emplace(key, static_cast<NodeId>(nodes_.size()));
+            if (inserted) {
+                nodes_.push_back({instruction.op, instruction.operand, lhs, rhs, bytecode.positions[pc], 0});
+                if (instruction.op == OpCode::NEG) {
+                    ++nodes_[lhs].uses;
+                } else if (!is_leaf(instruction.op)) {
+                    ++nodes_[lhs].uses;
+                    ++nodes_[rhs].uses;
+                }
+            }
+            stack.push_back(it->second);
+        }
+        if (!stack.empty()) root_ = stack.back();
+    }
+
+    size_t ExpressionDag::size() const {
+        return nodes_.size();
+    }
+
+    ExpressionDag::NodeId ExpressionDag::root() const {
+        return root_;
+    }
+
+    const ExpressionDag::Node& ExpressionDag::node(NodeId id) const {
+        return nodes_[id];
+    }
+
+    size_t ExpressionDag::shared_count() const {
+        size_t count = 0;
+        for (const auto& node : nodes_) {
+            if (!is_leaf(node.op) && node.uses > 1) ++count;
+        }
+        return count;
+    }
+
+    void ExpressionDag::emit(Bytecode& bytecode) const {
+        bytecode.code.clear();
+        bytecode.positions.clear();
+        bytecode.temp_count = 0;
+        if (nodes_.empty()) return;
+
+        // 用显式栈做后序遍历，很长的左结合链也不会耗尽调用栈
+        std::vector<std::uint32_t> temps(nodes_.size(), kNoTemp);
+        std::vector<std::pair<NodeId, bool>> work{{root_, false}};
+        size_t depth = 0;
+        bytecode.max_stack = 0;
+        auto emit = [&](OpCode op, std::uint32_t operand, size_t position) {
+            bytecode.code.push_back({op, operand});
+            bytecode.positions.push_back(position);
+        };
+
+        while (!work.empty()) {
+            auto [id, expanded] = work.back();
+            work.pop_back();
+            const Node& node = nodes_[id];
+            if (is_leaf(node.op) || temps[id] != kNoTemp) {
+                if (is_leaf(node.op)) emit(node.op, node.operand, node.position);
+                else emit(OpCode::LOAD_TEMP, temps[id], node.position);
+                if (++depth > bytecode.max_stack) bytecode.max_stack = depth;
+                continue;
+            }
+            if (!expanded) {
+                work.push_back({id, true});
+                if (node.op != OpCode::NEG) work.push_back({node.rhs, false});
+                work.push_back({node.lhs, false});
+                continue;
+            }
+            emit(node.op, 0, node.position);
+            if (node.op != OpCode::NEG) --depth;
+            if (node.uses > 1) {
+                temps[id] = static_cast<std::uint32_t>(bytecode.temp_count++);
+                emit(OpCode::STORE_TEMP, temps[id], node.position);
+            }
+        }
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,43 @@
+#ifndef EXPRCALC_EXPRESSION_DAG_H
+#define EXPRCALC_EXPRESSION_DAG_H
+
+#include "bytecode.h"
+#include <cstdint>
+#include <vector>
+
+namespace exprcalc {
+
+    // 哈希共享（hash-consing）的表达式 DAG：结构相同的子树只保留一个节点。
+    // a + b 与 b + a 视为同一节点（IEEE 加法和乘法满足交换律）
+    class ExpressionDag {
+    public:
+        using NodeId = std::uint32_t;
+
+        struct Node {
+            OpCode op;
+            std::uint32_t operand; // 叶子节点的常量下标或变量槽位
+            NodeId lhs;            // 一元运算（NEG）只用 lhs
+            NodeId rhs;
+            size_t position;       // 第一次出现的位置，用于错误报告
+            std::uint32_t uses;    // 被父节点引用的次数
+        };
+
+        explicit ExpressionDag(const Bytecode& bytecode);
+
+        size_t size() const;
+        NodeId root() const;
+        const Node& node(NodeId id) const;
+        size_t shared_count() const; // 被多次引用的运算节点数
+
+        // 按原来的求值顺序重新生成字节码：被多次引用的运算只算一次，结果放进临时槽位。
+        // 常量池和变量表沿用构造时的字节码
+        void emit(Bytecode& bytecode) const;
+
+    private:
+        std::vector<Node> nodes_;
+        NodeId root_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_EXPRESSION_DAG_H
@@ -0,0 +1,109 @@
+#ifndef EXPRCALC_INTERPRETER_H
+#define EXPRCALC_INTERPRETER_H
+
+#include "bytecode.h"
+#include "error.h"
+#include "numeric.h"
+#include "stack_buffer.h"
+
+namespace exprcalc {
+
+    namespace detail {
+        inline constexpr size_t kInlineStackSize = 64; // 绝大多数表达式的栈深度都不会超过该值
+        inline constexpr size_t kInlineTempCount = 16;
+        inline constexpr size_t kInlineValueCount = 32;
+    }
+
+    namespace detail {
+        // 解释循环本身；pc 通过引用传出，出错时调用方据此定位
+        template <typename Arithmetic>
+        typename Arithmetic::value_type run(const Bytecode& bytecode, const typename Arithmetic::value_type* constants,
+                                            const typename Arithmetic::value_type* slots, const Arithmetic& arithmetic,
+                                            size_t& pc) {
+            using Value = typename Arithmetic::value_type;
+            StackBuffer<Value, kInlineStackSize> buffer(bytecode.max_stack);
+            Value* stack = buffer.data();
+            StackBuffer<Value, kInlineTempCount> temps(bytecode.temp_count);
+            const Instruction* code = bytecode.code.data();
+            const size_t size = bytecode.code.size();
+            size_t top = 0;
+
+            for (pc = 0; pc < size; ++pc) {
+                const Instruction instruction = code[pc];
+                switch (instruction.op) {
+                    case OpCode::PUSH_CONST:
+                        stack[top++] = constants[instruction.operand];
+                        break;
+                    case OpCode::LOAD_VAR:
+                        stack[top++] = slots[instruction.operand];
+                        break;
+                    case OpCode::ADD:
+                        --top;
+                        stack[top - 1] = arithmetic.add(stack[top - 1], stack[top]);
+                        break;
+                    case OpCode::SUB:
+                        --top;
+                        stack[top - 1] = arithmetic.sub(stack[top - 1], stack[top]);
+                        break;
+                    case OpCode::MUL:
+                        --top;
+                        stack[top - 1] = arithmetic.mul(stack[top - 1], stack[top]);
+                        break;
+                    case OpCode::DIV:
+                        --top;
+                        if (arithmetic.is_zero(stack[top])) throw CalculationError("Division by zero", bytecode.positions[pc]);
+                        stack[top - 1] = arithmetic.div(stack[top - 1], stack[top]);
+                        break;
+                    case OpCode::NEG:
+                        stack[top - 1] = arithmetic.neg(stack[top - 1]);
+                        break;
+                    case OpCode::STORE_TEMP:
+                        temps[instruction.operand] = stack[top - 1];
+                        break;
+                    case OpCode::LOAD_TEMP:
+                        stack[top++] = temps[instruction.operand];
+                        break;
+                }
+            }
+            return stack[0];
+        }
+    }
+
+    // 字节码解释器，Arithmetic 决定数值类型和四则运算（见 numeric.h）。
+    // 用 DoubleArithmetic 实例化时生成的代码与直接写 double 运算相同；
+    // 只有会溢出的后端才包一层异常处理，否则 double 路径会慢约两成
+    template <typename Arithmetic>
+    typename Arithmetic::value_type interpret(const Bytecode& bytecode, const typename Arithmetic::value_type* constants,
+                                              const typename Arithmetic::value_type* slots,
+                                              const Arithmetic& arithmetic = {}) {
+        size_t pc = 0;
+        if constexpr (Arithmetic::may_overflow) {
+            try {
+                return detail::run(bytecode, constants, slots, arithmetic, pc);
+            } catch (const ArithmeticOverflow&) {
+                throw CalculationError("Numeric overflow", bytecode.positions[pc]);
+            }
+        } else {
+            return detail::run(bytecode, constants, slots, arithmetic, pc);
+        }
+    }
+
+    // constants 是已转换好的常量池；变量槽位是 double，先用 Arithmetic::from_double 转换再解释执行
+    template <typename Arithmetic>
+    typename Arithmetic::value_type interpret_converted(const Bytecode& bytecode,
+                                                        const typename Arithmetic::value_type* constants,
+                                                        const double* slots, const Arithmetic& arithmetic = {}) {
+        StackBuffer<typename Arithmetic::value_type, detail::kInlineValueCount> values(bytecode.variables.size());
+        try {
+            for (size_t i = 0; i < bytecode.variables.size(); ++i) {
+                values[i] = arithmetic.from_double(slots[i]);
+            }
+        } catch (const ArithmeticOverflow&) {
+            throw CalculationError("Numeric overflow", 0); // 变量值超出后端的表示范围
+        }
+        return interpret(bytecode, constants, values.data(), arithmetic);
+    }
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_INTERPRETER_H
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "jit.h"
+#include "error.h"
+#include "interpreter.h"
+#include "stack_buffer.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_WIN32)
+#include <windows.h>
+#define EXPRCALC_JIT_WIN64 1
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define EXPRCALC_JIT_SYSV 1
+#endif
+#endif
+
+namespace exprcalc {
+
+    namespace {
+
+#if defined(EXPRCALC_JIT_SYSV) || defined(EXPRCALC_JIT_WIN64)
+#define EXPRCALC_JIT_ENABLED 1
+
+        // 调用约定相关的寄存器编号（x86-64 通用寄存器编码）
+        constexpr std::uint8_t RDX = 2, RSI = 6, RDI = 7, RCX = 1, R8 = 8, R9 = 9;
+
+#if defined(EXPRCALC_JIT_WIN64)
+        // Win64 下 XMM6-XMM15 由被调用者保存，只使用易失寄存器
+        constexpr std::uint8_t kSlotsReg = RCX, kConstantsReg = RDX, kTempsReg = R8, kErrorReg = R9;
+        constexpr std::uint8_t kScratchXmm = 5;
+#else
+        constexpr std::uint8_t kSlotsReg = RDI, kConstantsReg = RSI, kTempsReg = RDX, kErrorReg = RCX;
+        constexpr std::uint8_t kScratchXmm = 15;
+#endif
+        constexpr size_t kMaxRegisterStack = kScratchXmm; // XMM0..scratch-1 用作求值栈
+
+        class Assembler {
+        public:
+            std::vector<std::uint8_t> bytes;
+
+            // movsd xmm, [base + disp32]
+            void load(std::uint8_t xmm, std::uint8_t base, std::int32_t disp) {
+                emit(0xF2);
+                rex(xmm, base);
+                emit(0x0F); emit(0x10);
+                emit(static_cast<std::uint8_t>(0x80 | ((xmm & 7) << 3) | (base & 7)));
+                imm32(static_cast<std::uint32_t>(disp));
+            }
+
+            // movsd [base + disp32], xmm
+            void store(std::uint8_t base, std::int32_t disp, std::uint8_t xmm) {
+                emit(0xF2);
+                rex(xmm, base);
+                emit(0x0F); emit(0x11);
+                emit(static_cast<std::uint8_t>(0x80 | ((xmm & 7) << 3) | (base & 7)));
+                imm32(static_cast<std::uint32_t>(disp));
+            }
+
+            // addsd/subsd/mulsd/divsd dst, src
+            void arith(std::uint8_t opcode, std::uint8_t dst, std::uint8_t src) {
+                emit(0xF2);
+                rex(dst, src);
+                emit(0x0F); emit(opcode);
+                modrm_reg(dst, src);
+            }
+
+            // xorpd dst, src
+            void bitwise_xor(std::uint8_t dst, std::uint8_t src) {
+                emit(0x66);
+                rex(dst, src);
+                emit(0x0F); emit(0x57);
+                modrm_reg(dst, src);
+            }
+
+            void zero(std::uint8_t xmm) {
+                bitwise_xor(xmm, xmm);
+            }
+
+            // ucomisd a, b
+            void compare(std::uint8_t a, std::uint8_t b) {
+                emit(0x66);
+                rex(a, b);
+                emit(0x0F); emit(0x2E);
+                modrm_reg(a, b);
+            }
+
+            // mov dword [base], imm32
+            void store_imm32(std::uint8_t base, std::uint32_t value) {
+                rex(0, base);
+                emit(0xC7);
+                emit(static_cast<std::uint8_t>(base & 7));
+                imm32(value);
+            }
+
+            void emit(std::uint8_t byte) { bytes.push_back(byte); }
+
+        private:
+            void rex(std::uint8_t reg, std::uint8_t rm) {
+                std::uint8_t prefix = 0x40 | ((reg & 8) >> 1) | ((rm & 8) >> 3);
+                if (prefix != 0x40) emit(prefix);
+            }
+
+            void modrm_reg(std::uint8_t reg, std::uint8_t rm) {
+                emit(static_cast<std::uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+            }
+
+            void imm32(std::uint32_t value) {
+                for (int i = 0; i < 4; ++i) emit(static_cast<std::uint8_t>(value >> (8 * i)));
+            }
+        };
+
+        bool generate(const Bytecode& bytecode, Assembler& as) {
+            if (bytecode.max_stack > kMaxRegisterStack) return false;
+            bool has_division = false;
+            for (const auto& instruction : bytecode.code) {
+                if (instruction.op == OpCode::DIV) {
+                    has_division = true;
+                    as.zero(kScratchXmm); // 除零检查用的 0.0
+                    break;
+                }
+            }
+            // JitFunction 在常量池末尾追加了 -0.0（只有符号位），NEG 与它异或翻转符号位，NaN 也与解释器的取反一致
+            const auto sign_mask = static_cast<std::int32_t>(bytecode.constants.size() * sizeof(double));
+
+            std::uint8_t top = 0; // 栈顶对应的下一个空闲 XMM 寄存器
+            for (size_t pc = 0; pc < bytecode.code.size(); ++pc) {
+                const Instruction instruction = bytecode.code[pc];
+                switch (instruction.op) {
+                    case OpCode::PUSH_CONST:
+                        as.load(top++, kConstantsReg, static_cast<std::int32_t>(instruction.operand * sizeof(double)));
+                        break;
+                    case OpCode::LOAD_VAR:
+                        as.load(top++, kSlotsReg, static_cast<std::int32_t>(instruction.operand * sizeof(double)));
+                        break;
+                    case OpCode::ADD: --top; as.arith(0x58, top - 1, top); break;
+                    case OpCode::SUB: --top; as.arith(0x5C, top - 1, top); break;
+                    case OpCode::MUL: --top; as.arith(0x59, top - 1, top); break;
+                    case OpCode::DIV:
+                        --top;
+                        // 除数 == 0（且不是 NaN）时写入出错位置并返回
+                        as.compare(top, kScratchXmm);
+                        as.emit(0x7A); as.emit(0x00); // jp  ok（NaN）
+                        as.emit(0x75); as.emit(0x00); // jne ok
+                        {
+                            const size_t stub = as.bytes.size();
+                            as.store_imm32(kErrorReg, static_cast<std::uint32_t>(pc + 1));
+                            as.emit(0xC3);            // ret
+                            const size_t stub_size = as.bytes.size() - stub;
+                            as.bytes[stub - 3] = static_cast<std::uint8_t>(stub_size + 2);
+                            as.bytes[stub - 1] = static_cast<std::uint8_t>(stub_size);
+                        }
+                        as.arith(0x5E, top - 1, top);
+                        break;
+                    case OpCode::NEG:
+                        as.load(kScratchXmm, kConstantsReg, sign_mask);
+                        as.bitwise_xor(top - 1, kScratchXmm);
+                        if (has_division) as.zero(kScratchXmm);
+                        break;
+                    case OpCode::STORE_TEMP:
+                        as.store(kTempsReg, static_cast<std::int32_t>(instruction.operand * sizeof(double)), top - 1);
+                        break;
+                    case OpCode::LOAD_TEMP:
+                        as.load(top++, kTempsReg, static_cast<std::int32_t>(instruction.operand * sizeof(double)));
+                        break;
+                    default:
+                        return false; // 不认识的指令交给解释器
+                }
+            }
+            as.emit(0xC3); // 结果已经在 XMM0 中
+            return true;
+        }
+
+        void* allocate_executable(const std::vector<std::uint8_t>& code) {
+#if defined(EXPRCALC_JIT_WIN64)
+            void* memory = VirtualAlloc(nullptr, code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+            if (memory == nullptr) return nullptr;
+            std::memcpy(memory, code.data(), code.size());
+            DWORD old_protect;
+            if (!VirtualProtect(memory, code.size(), PAGE_EXECUTE_READ, &old_protect)) {
+                VirtualFree(memory, 0, MEM_RELEASE);
+                return nullptr;
+            }
+            FlushInstructionCache(GetCurrentProcess(), memory, code.size());
+            return memory;
+#else
+            // 先可写后可执行，任何时刻页面都不同时可写可执行
+            void* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) return nullptr;
+            std::memcpy(memory, code.data(), code.size());
+            if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0) {
+                munmap(memory, code.size());
+                return nullptr;
+            }
+            return memory;
+#endif
+        }
+
+        void release_executable(void* memory, size_t size) {
+#if defined(EXPRCALC_JIT_WIN64)
+            (void)size;
+            VirtualFree(memory, 0, MEM_RELEASE);
+#else
+            munmap(memory, size);
+#endif
+        }
+
+#endif // EXPRCALC_JIT_SYSV || EXPRCALC_JIT_WIN64
+
+    } // namespace
+
+    std::unique_ptr<JitFunction> JitFunction::compile(const Bytecode& bytecode) {
+#if defined(EXPRCALC_JIT_ENABLED)
+        Assembler as;
+        if (!generate(bytecode, as)) return nullptr;
+        void* memory = allocate_executable(as.bytes);
+        if (memory == nullptr) return nullptr;
+        return std::unique_ptr<JitFunction>(new JitFunction(memory, as.bytes.size(), bytecode));
+#else
+        (void)bytecode;
+        return nullptr;
+#endif
+    }
+
+    bool JitFunction::available() {
+#if defined(EXPRCALC_JIT_ENABLED)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    JitFunction::JitFunction(void* memory, size_t size, const Bytecode& bytecode)
+        : memory_(memory), size_(size), entry_(reinterpret_cast<EntryPoint>(memory)),
+          constants_(bytecode.constants), positions_(bytecode.positions), temp_count_(bytecode.temp_count) {
+        constants_.push_back(-0.0); // NEG 使用的符号位掩码
+    }
+
+    JitFunction::~JitFunction() {
+#if defined(EXPRCALC_JIT_ENABLED)
+        release_executable(memory_, size_);
+#endif
+    }
+
+    double JitFunction::evaluate(const double* slots) const {
+        std::uint32_t error_pc = 0;
+        StackBuffer<double, detail::kInlineTempCount> temps(temp_count_);
+        double result = entry_(slots, constants_.data(), temps.data(), &error_pc);
+        if (error_pc != 0) {
+            throw CalculationError("Division by zero", positions_[error_pc - 1]);
+        }
+        return result;
+    }
+
+    size_t JitFunction::code_size() const {
+        return size_;
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,43 @@
+#ifndef EXPRCALC_JIT_H
+#define EXPRCALC_JIT_H
+
+#include "bytecode.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace exprcalc {
+
+    // 把字节码编译成 x86-64 本机代码：求值栈直接映射到 XMM 寄存器，
+    // 变量从槽位数组加载，常量从常量池加载
+    class JitFunction {
+    public:
+        // 平台不支持、或表达式超出寄存器分配能力时返回 nullptr，调用方应退回到解释器
+        static std::unique_ptr<JitFunction> compile(const Bytecode& bytecode);
+        static bool available();
+
+        ~JitFunction();
+        JitFunction(const JitFunction&) = delete;
+        JitFunction& operator=(const JitFunction&) = delete;
+
+        double evaluate(const double* slots) const;
+        size_t code_size() const;
+
+    private:
+        // temps 存放公共子表达式；error_pc 在除数为 0 时被写成出错指令下标 + 1
+        using EntryPoint = double (*)(const double* slots, const double* constants, double* temps,
+                                      std::uint32_t* error_pc);
+
+        JitFunction(void* memory, size_t size, const Bytecode& bytecode);
+
+        void* memory_;
+        size_t size_;
+        EntryPoint entry_;
+        std::vector<double> constants_;
+        std::vector<size_t> positions_;
+        size_t temp_count_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_JIT_H
@@ -1,65 +1,139 @@
 #include "lexer.h"
+#include "char_class.h"
 #include "error.h"
-#include <cctype>
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <string>
 
 namespace exprcalc {
 
-    Lexer::Lexer(std::string input) : input_(std::move(input)), pos_(0) {}
+    namespace {
+
+        // 去掉数字分隔符后用 from_chars 转换（正确舍入，不受 locale 影响）；
+        // 分隔符 '_' 必须夹在两个数字之间
+        double parse_number(std::string_view text, bool hex, size_t position) {
+            std::string_view digits = hex ? text.substr(2) : text;
+            const std::uint8_t digit_class = hex ? CHAR_HEX_DIGIT : CHAR_DIGIT;
+            std::string stripped;
+            if (digits.find('_') != std::string_view::npos) {
+                for (size_t i = 0; i < digits.size(); ++i) {
+                    if (digits[i] != '_') {
+                        stripped.push_back(digits[i]);
+                    } else if (i == 0 || i + 1 == digits.size() || !has_class(digits[i - 1], digit_class) ||
+                               !has_class(digits[i + 1], digit_class)) {
+                        throw CalculationError("Invalid number: " + std::string(text), position);
+                    }
+                }
+                digits = stripped;
+            }
+            double number = 0.0;
+            auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), number,
+                                             hex ? std::chars_format::hex : std::chars_format::general);
+            if (ec == std::errc::result_out_of_range) {
+                throw CalculationError("Number out of range: " + std::string(text), position);
+            }
+            if (ec != std::errc() || end != digits.data() + digits.size()) {
+                throw CalculationError("Invalid number: " + std::string(text), position);
+            }
+            return number;
+        }
+
+    } // namespace
+
+    Lexer::Lexer(std::string_view input)
+        : input_(input), pos_(0), classify_(best_classify_kernel()), block_start_(std::string_view::npos), masks_{0, 0, 0} {}
+
+    Lexer::Lexer(std::string_view input, SimdLevel scan_level)
+        : input_(input), pos_(0), classify_(classify_kernel_for(scan_level)), block_start_(std::string_view::npos),
+          masks_{0, 0, 0} {}
 
     std::vector<Token> Lexer::tokenize() {
         std::vector<Token> tokens;
-        while (pos_ < input_.size()) {
-            skip_whitespace();
-            if (pos_ >= input_.size()) break;
-            tokens.push_back(next_token());
+        for (Token token = next(); token.type != TokenType::END; token = next()) {
+            tokens.push_back(token);
         }
         return tokens;
     }
 
+    Token Lexer::next() {
+        skip_whitespace();
+        if (pos_ >= input_.size()) return Token(TokenType::END, {}, input_.size());
+        return next_token();
+    }
+
     void Lexer::skip_whitespace() {
-        while (pos_ < input_.size() && std::isspace(input_[pos_])) {
-            ++pos_;
+        pos_ = run_end(&CharMasks::space, pos_);
+    }
+
+    // 输入按 kScanBlock 字节分块整体分类，之后每个标记的边界只需一次位运算；
+    // 一个块通常覆盖十几个标记，分类的开销被它们分摊
+    size_t Lexer::run_end(std::uint64_t CharMasks::* mask, size_t pos) {
+        while (pos < input_.size()) {
+            const size_t block = pos - pos % kScanBlock;
+            if (block != block_start_) {
+                block_start_ = block;
+                masks_ = classify_(input_.data() + block, std::min(kScanBlock, input_.size() - block));
+            }
+            // 块外的位都是 0，取反后为 1，因此在输入末尾也会停下
+            const std::uint64_t outside = ~(masks_.*mask) >> (pos - block);
+            if (outside != 0) return pos + std::countr_zero(outside);
+            pos = block + kScanBlock;
         }
+        return input_.size();
     }
 
     Token Lexer::next_token() {
-        char current = input_[pos_];
+        const char current = input_[pos_];
+        const size_t start_pos = pos_;
 
-        // 数字
-        if (std::isdigit(current) || current == '.') {
-            std::string number;
-            size_t start_pos = pos_;
-            while (pos_ < input_.size() && (std::isdigit(input_[pos_]) || input_[pos_] == '.')) {
-                number += input_[pos_++];
-            }
-            return Token(TokenType::NUMBER, number, start_pos);
+        // 首字符查一次表即可确定标记种类；按常见程度排列判断顺序，比跳转表更利于分支预测
+        const TokenStart start = char_info(current).start;
+        if (start == TokenStart::OPERATOR) {
+            return Token(TokenType::OPERATOR, input_.substr(pos_++, 1), start_pos, find_operator(current)->op);
         }
-
-        // 运算符
-        if (current == '+' || current == '-' || current == '*' || current == '/') {
-            std::string op(1, current);
-            return Token(TokenType::OPERATOR, op, pos_++);
+        if (start == TokenStart::NUMBER) {
+            return scan_number();
         }
-
-        // 括号
-        if (current == '(') {
-            return Token(TokenType::LEFT_PAREN, "(", pos_++);
+        if (start == TokenStart::IDENTIFIER) {
+            pos_ = run_end(&CharMasks::ident, pos_);
+            return Token(TokenType::VARIABLE, input_.substr(start_pos, pos_ - start_pos), start_pos);
+        }
+        if (start == TokenStart::LEFT_PAREN) {
+            return Token(TokenType::LEFT_PAREN, input_.substr(pos_++, 1), start_pos);
         }
-        if (current == ')') {
-            return Token(TokenType::RIGHT_PAREN, ")", pos_++);
+        if (start == TokenStart::RIGHT_PAREN) {
+            return Token(TokenType::RIGHT_PAREN, input_.substr(pos_++, 1), start_pos);
         }
+        throw CalculationError("Invalid character: " + std::string(1, current), pos_);
+    }
 
-        // 变量
-        if (std::isalpha(current)) {
-            std::string var;
-            size_t start_pos = pos_;
-            while (pos_ < input_.size() && std::isalnum(input_[pos_])) {
-                var += input_[pos_++];
+    // 十进制 1_000.5e-3 或十六进制 0x1.8p3；先贪婪地取完尾数中的数字、'.' 和 '_'，
+    // 这样 "1.2.3" 整体报错。指数只在后面确实跟着数字时才吃进来，"2e" 仍是数字 2 后跟变量 e
+    Token Lexer::scan_number() {
+        const size_t start_pos = pos_;
+        const bool hex = input_[pos_] == '0' && pos_ + 1 < input_.size() &&
+                         (input_[pos_ + 1] == 'x' || input_[pos_ + 1] == 'X');
+        if (hex) {
+            pos_ += 2;
+            while (pos_ < input_.size() && has_class(input_[pos_], CHAR_HEX_DIGIT | CHAR_NUMBER_PART)) {
+                ++pos_;
             }
-            return Token(TokenType::VARIABLE, var, start_pos);
+        } else {
+            pos_ = run_end(&CharMasks::number, pos_);
         }
-
-        throw CalculationError("Invalid character: " + std::string(1, current), pos_);
+        if (pos_ < input_.size() && (input_[pos_] | 0x20) == (hex ? 'p' : 'e')) {
+            size_t exponent = pos_ + 1;
+            if (exponent < input_.size() && (input_[exponent] == '+' || input_[exponent] == '-')) ++exponent;
+            if (exponent < input_.size() && is_digit(input_[exponent])) {
+                pos_ = exponent;
+                while (pos_ < input_.size() && (is_digit(input_[pos_]) || input_[pos_] == '_')) {
+                    ++pos_;
+                }
+            }
+        }
+        auto text = input_.substr(start_pos, pos_ - start_pos);
+        return Token(TokenType::NUMBER, text, start_pos, parse_number(text, hex, start_pos));
     }
 
 } // namespace exprcalc
\ No newline at end of file
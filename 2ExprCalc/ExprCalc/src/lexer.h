@@ -1,22 +1,34 @@
 #ifndef EXPRCALC_LEXER_H
 #define EXPRCALC_LEXER_H
 
+#include "scan_kernels.h"
 #include "token.h"
-#include <string>
+#include <string_view>
 #include <vector>
 
 namespace exprcalc {
 
     class Lexer {
     public:
-        explicit Lexer(std::string input);
+        // 只借用输入，不做拷贝；返回的 Token 引用输入中的片段
+        explicit Lexer(std::string_view input);
+        // 指定字符分类内核的级别，用于测试和基准对比；超出 CPU 支持时自动降级
+        Lexer(std::string_view input, SimdLevel scan_level);
         std::vector<Token> tokenize();
+        // 拉取式接口：按值返回下一个标记，输入结束后一直返回 END（位置为输入长度）
+        Token next();
 
     private:
-        std::string input_;
+        std::string_view input_;
         size_t pos_;
+        ClassifyKernel classify_;
+        size_t block_start_; // 当前已分类块在输入中的起点（kScanBlock 的整数倍），尚未分类时为 npos
+        CharMasks masks_;
+        // 从 pos 开始、连续属于 mask 所选类别的字节的结尾
+        size_t run_end(std::uint64_t CharMasks::* mask, size_t pos);
         void skip_whitespace();
         Token next_token();
+        Token scan_number();
     };
 
 } // namespace exprcalc
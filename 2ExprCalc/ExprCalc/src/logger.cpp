@@ -9,6 +9,10 @@ namespace exprcalc {
         enabled_ = enabled;
     }
 
+    bool Logger::is_enabled() const {
+        return enabled_;
+    }
+
     void Logger::log_tokens(const std::vector<Token>& tokens) const {
         if (!enabled_) return;
         out_ << "Tokens:\n";
@@ -29,6 +33,12 @@ namespace exprcalc {
         }
     }
 
+    void Logger::log_optimization(const OptimizationStats& stats) const {
+        if (!enabled_) return;
+        out_ << "Optimized: " << stats.nodes_before << " -> " << stats.nodes_after
+             << " nodes (" << stats.removed() << " removed, " << stats.temporaries << " shared)\n";
+    }
+
     void Logger::log_result(double result) const {
         if (!enabled_) return;
         out_ << "Result: " << result << '\n';
@@ -41,6 +51,7 @@ namespace exprcalc {
             case TokenType::VARIABLE: return "VARIABLE";
             case TokenType::LEFT_PAREN: return "LEFT_PAREN";
             case TokenType::RIGHT_PAREN: return "RIGHT_PAREN";
+            case TokenType::END: return "END";
         }
         return "UNKNOWN";
     }
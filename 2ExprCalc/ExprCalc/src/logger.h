@@ -1,6 +1,7 @@
 #ifndef EXPRCALC_LOGGER_H
 #define EXPRCALC_LOGGER_H
 
+#include "optimizer.h"
 #include "token.h"
 #include <ostream>
 #include <iostream>
@@ -12,8 +13,10 @@ namespace exprcalc {
     public:
         explicit Logger(std::ostream& out = std::cout);
         void set_enabled(bool enabled);
+        bool is_enabled() const;
         void log_tokens(const std::vector<Token>& tokens) const;
         void log_rpn(const std::vector<Token>& rpn) const;
+        void log_optimization(const OptimizationStats& stats) const;
         void log_result(double result) const;
 
     private:
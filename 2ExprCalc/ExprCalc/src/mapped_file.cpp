@@ -0,0 +1,72 @@
+#include "mapped_file.h"
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace exprcalc {
+
+    MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot read size of " + path);
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping); // 映射视图会保持映射对象存活
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            throw std::runtime_error("Not a regular file: " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* memory = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (memory != MAP_FAILED) {
+                madvise(memory, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(memory);
+            }
+        }
+        close(fd); // 映射建立后不再需要文件描述符
+#endif
+        if (size_ > 0 && data_ == nullptr) throw std::runtime_error("Cannot map " + path);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data_ == nullptr) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    std::string_view MappedFile::view() const {
+        return {data_, size_};
+    }
+
+    size_t MappedFile::size() const {
+        return size_;
+    }
+
+} // namespace exprcalc
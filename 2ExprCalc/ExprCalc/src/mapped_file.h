@@ -0,0 +1,28 @@
+#ifndef EXPRCALC_MAPPED_FILE_H
+#define EXPRCALC_MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+namespace exprcalc {
+
+    // 只读内存映射文件：行直接以 string_view 的形式交给词法分析器，不经过复制。
+    // 映射时提示内核按顺序访问，便于预读并及早回收已读过的页
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path); // 打开或映射失败时抛出 std::runtime_error
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view view() const;
+        size_t size() const;
+
+    private:
+        const char* data_;
+        size_t size_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_MAPPED_FILE_H
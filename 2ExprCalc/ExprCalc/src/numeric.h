@@ -0,0 +1,189 @@
+#ifndef EXPRCALC_NUMERIC_H
+#define EXPRCALC_NUMERIC_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace exprcalc {
+
+    // 解释器的数值后端。每个后端提供：
+    //   value_type、from_double（常量和变量都以 double 存储，求值前转换）、
+    //   add / sub / mul / div / neg 以及 is_zero（除零检查由解释器统一报错）。
+    // 结果无法表示时后端抛出 ArithmeticOverflow 并把 may_overflow 设为 true，由解释器补上出错位置
+    struct ArithmeticOverflow {};
+
+    struct DoubleArithmetic {
+        using value_type = double;
+        static constexpr bool may_overflow = false;
+        static double from_double(double value) { return value; }
+        static double add(double lhs, double rhs) { return lhs + rhs; }
+        static double sub(double lhs, double rhs) { return lhs - rhs; }
+        static double mul(double lhs, double rhs) { return lhs * rhs; }
+        static double div(double lhs, double rhs) { return lhs / rhs; }
+        static double neg(double value) { return -value; }
+        static bool is_zero(double value) { return value == 0; }
+    };
+
+    // 整数模式的值：能用 int64 精确表示时 is_integer 为真并使用 integer，否则使用 real
+    struct IntegerValue {
+        bool is_integer;
+        std::int64_t integer;
+        double real;
+
+        static IntegerValue of(std::int64_t value) { return {true, value, 0.0}; }
+        static IntegerValue of_real(double value) { return {false, 0, value}; }
+        double to_double() const { return is_integer ? static_cast<double>(integer) : real; }
+    };
+
+    namespace detail {
+        // 返回 true 表示溢出
+        inline bool add_overflow(std::int64_t a, std::int64_t b, std::int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_add_overflow(a, b, out);
+#else
+            if ((b > 0 && a > std::numeric_limits<std::int64_t>::max() - b) ||
+                (b < 0 && a < std::numeric_limits<std::int64_t>::min() - b)) return true;
+            *out = a + b;
+            return false;
+#endif
+        }
+
+        inline bool sub_overflow(std::int64_t a, std::int64_t b, std::int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_sub_overflow(a, b, out);
+#else
+            if ((b < 0 && a > std::numeric_limits<std::int64_t>::max() + b) ||
+                (b > 0 && a < std::numeric_limits<std::int64_t>::min() + b)) return true;
+            *out = a - b;
+            return false;
+#endif
+        }
+
+        inline bool mul_overflow(std::int64_t a, std::int64_t b, std::int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_mul_overflow(a, b, out);
+#else
+            if (a != 0 && b != 0) {
+                const std::int64_t max = std::numeric_limits<std::int64_t>::max();
+                const std::int64_t min = std::numeric_limits<std::int64_t>::min();
+                if ((a == -1 && b == min) || (b == -1 && a == min)) return true;
+                if (a != -1 && b != -1 && (a > 0 ? (b > 0 ? a > max / b : b < min / a)
+                                                 : (b > 0 ? a < min / b : a < max / b))) return true;
+            }
+            *out = a * b;
+            return false;
+#endif
+        }
+    }
+
+    // 整数之间的加减乘用带溢出检查的 int64 运算，结果精确；
+    // 溢出、除不尽或有操作数不是整数时才退化为 double 运算
+    struct IntegerArithmetic {
+        using value_type = IntegerValue;
+        static constexpr bool may_overflow = false; // 溢出时退化为 double，不抛异常
+
+        static IntegerValue from_double(double value) {
+            // [-2^63, 2^63) 内的整数值按整数处理
+            if (value >= -0x1p63 && value < 0x1p63 && value == std::trunc(value)) {
+                return IntegerValue::of(static_cast<std::int64_t>(value));
+            }
+            return IntegerValue::of_real(value);
+        }
+
+        static IntegerValue add(const IntegerValue& lhs, const IntegerValue& rhs) {
+            std::int64_t result;
+            if (lhs.is_integer && rhs.is_integer && !detail::add_overflow(lhs.integer, rhs.integer, &result)) {
+                return IntegerValue::of(result);
+            }
+            return IntegerValue::of_real(lhs.to_double() + rhs.to_double());
+        }
+
+        static IntegerValue sub(const IntegerValue& lhs, const IntegerValue& rhs) {
+            std::int64_t result;
+            if (lhs.is_integer && rhs.is_integer && !detail::sub_overflow(lhs.integer, rhs.integer, &result)) {
+                return IntegerValue::of(result);
+            }
+            return IntegerValue::of_real(lhs.to_double() - rhs.to_double());
+        }
+
+        static IntegerValue mul(const IntegerValue& lhs, const IntegerValue& rhs) {
+            std::int64_t result;
+            if (lhs.is_integer && rhs.is_integer && !detail::mul_overflow(lhs.integer, rhs.integer, &result)) {
+                return IntegerValue::of(result);
+            }
+            return IntegerValue::of_real(lhs.to_double() * rhs.to_double());
+        }
+
+        // 能整除时仍是精确整数；除数为 0 的情况由解释器先行报错
+        static IntegerValue div(const IntegerValue& lhs, const IntegerValue& rhs) {
+            if (lhs.is_integer && rhs.is_integer && rhs.integer != 0 &&
+                !(rhs.integer == -1 && lhs.integer == std::numeric_limits<std::int64_t>::min()) &&
+                lhs.integer % rhs.integer == 0) {
+                return IntegerValue::of(lhs.integer / rhs.integer);
+            }
+            return IntegerValue::of_real(lhs.to_double() / rhs.to_double());
+        }
+
+        static IntegerValue neg(const IntegerValue& value) {
+            if (value.is_integer && value.integer != std::numeric_limits<std::int64_t>::min()) {
+                return IntegerValue::of(-value.integer);
+            }
+            return IntegerValue::of_real(-value.to_double());
+        }
+
+        static bool is_zero(const IntegerValue& value) {
+            return value.is_integer ? value.integer == 0 : value.real == 0;
+        }
+    };
+
+    // 整数模式的快速路径：不带类型标记的 int64，每步和 double 运算一样只有一个值。
+    // 溢出或除不尽时抛出 IntegerPromotion，由调用方改用 IntegerArithmetic 从头重新计算
+    struct IntegerPromotion {};
+
+    struct Int64Arithmetic {
+        using value_type = std::int64_t;
+        static constexpr bool may_overflow = false; // IntegerPromotion 不是错误，不由解释器转换
+
+        static std::int64_t from_double(double value) {
+            const IntegerValue converted = IntegerArithmetic::from_double(value);
+            if (!converted.is_integer) throw IntegerPromotion{};
+            return converted.integer;
+        }
+
+        static std::int64_t add(std::int64_t lhs, std::int64_t rhs) {
+            std::int64_t result;
+            if (detail::add_overflow(lhs, rhs, &result)) throw IntegerPromotion{};
+            return result;
+        }
+
+        static std::int64_t sub(std::int64_t lhs, std::int64_t rhs) {
+            std::int64_t result;
+            if (detail::sub_overflow(lhs, rhs, &result)) throw IntegerPromotion{};
+            return result;
+        }
+
+        static std::int64_t mul(std::int64_t lhs, std::int64_t rhs) {
+            std::int64_t result;
+            if (detail::mul_overflow(lhs, rhs, &result)) throw IntegerPromotion{};
+            return result;
+        }
+
+        static std::int64_t div(std::int64_t lhs, std::int64_t rhs) {
+            if ((rhs == -1 && lhs == std::numeric_limits<std::int64_t>::min()) || lhs % rhs != 0) {
+                throw IntegerPromotion{};
+            }
+            return lhs / rhs;
+        }
+
+        static std::int64_t neg(std::int64_t value) {
+            if (value == std::numeric_limits<std::int64_t>::min()) throw IntegerPromotion{};
+            return -value;
+        }
+
+        static bool is_zero(std::int64_t value) { return value == 0; }
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_NUMERIC_H
\ No newline at end of file
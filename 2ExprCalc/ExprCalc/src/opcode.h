@@ -0,0 +1,27 @@
+#ifndef EXPRCALC_OPCODE_H
+#define EXPRCALC_OPCODE_H
+
+#include <cstdint>
+
+namespace exprcalc {
+
+    enum class OpCode : std::uint8_t {
+        PUSH_CONST, // 压入常量池中的常量
+        LOAD_VAR,   // 压入变量槽位中的值
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        NEG,        // 一元负号：栈顶取反
+        STORE_TEMP, // 把栈顶复制到临时槽位（不出栈），供后面的 LOAD_TEMP 复用
+        LOAD_TEMP   // 压入临时槽位中已算好的公共子表达式
+    };
+
+    struct Instruction {
+        OpCode op;
+        std::uint32_t operand; // PUSH_CONST 为常量下标，LOAD_VAR 为变量槽位，STORE_TEMP/LOAD_TEMP 为临时槽位
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_OPCODE_H
@@ -0,0 +1,77 @@
+#ifndef EXPRCALC_OPERATORS_H
+#define EXPRCALC_OPERATORS_H
+
+#include "opcode.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace exprcalc {
+
+    enum class Operator : std::uint8_t {
+        ADD,
+        SUB,
+        MUL,
+        DIV
+    };
+
+    enum class Associativity : std::uint8_t {
+        LEFT,
+        RIGHT
+    };
+
+    // 运算符的全部元数据，词法分析、逆波兰转换和字节码生成共用这一张表。
+    // 出现在运算符位置时：arity 为 2 是中缀，为 1 是后缀；
+    // prefix_precedence 大于 0 的运算符还可以出现在操作数位置作前缀（目前只有 Pratt 解析器支持前缀和后缀）
+    struct OperatorInfo {
+        Operator op;
+        char symbol;
+        int precedence;
+        Associativity associativity;
+        int arity;
+        OpCode opcode;
+        int prefix_precedence;
+        OpCode prefix_opcode;
+    };
+
+    // 按 Operator 枚举值顺序排列；新增运算符只需在这里加一行（以及对应的求值指令）
+    inline constexpr std::array<OperatorInfo, 4> kOperators{{
+        {Operator::ADD, '+', 1, Associativity::LEFT, 2, OpCode::ADD, 0, OpCode::ADD},
+        {Operator::SUB, '-', 1, Associativity::LEFT, 2, OpCode::SUB, 3, OpCode::NEG}, // -x 比乘除结合得更紧
+        {Operator::MUL, '*', 2, Associativity::LEFT, 2, OpCode::MUL, 0, OpCode::MUL},
+        {Operator::DIV, '/', 2, Associativity::LEFT, 2, OpCode::DIV, 0, OpCode::DIV},
+    }};
+
+    constexpr bool operators_in_enum_order() {
+        for (size_t i = 0; i < kOperators.size(); ++i) {
+            if (static_cast<size_t>(kOperators[i].op) != i) return false;
+        }
+        return true;
+    }
+    static_assert(operators_in_enum_order(), "kOperators must be indexed by Operator");
+
+    constexpr const OperatorInfo& operator_info(Operator op) {
+        return kOperators[static_cast<size_t>(op)];
+    }
+
+    namespace detail {
+        // 字符 -> kOperators 下标 + 1，0 表示不是运算符
+        constexpr std::array<std::uint8_t, 256> make_operator_index() {
+            std::array<std::uint8_t, 256> index{};
+            for (size_t i = 0; i < kOperators.size(); ++i) {
+                index[static_cast<unsigned char>(kOperators[i].symbol)] = static_cast<std::uint8_t>(i + 1);
+            }
+            return index;
+        }
+        inline constexpr std::array<std::uint8_t, 256> kOperatorIndex = make_operator_index();
+    }
+
+    // 不是运算符时返回 nullptr
+    constexpr const OperatorInfo* find_operator(char symbol) {
+        std::uint8_t index = detail::kOperatorIndex[static_cast<unsigned char>(symbol)];
+        return index == 0 ? nullptr : &kOperators[index - 1];
+    }
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_OPERATORS_H
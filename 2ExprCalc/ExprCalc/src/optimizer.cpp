@@ -0,0 +1,196 @@
+#include "optimizer.h"
+#include "expression_dag.h"
+#include "numeric.h"
+#include <cmath>
+#include <cstdint>
+
+namespace exprcalc {
+
+    namespace {
+        // 栈上的一个操作数对应输出字节码中的一段连续指令
+        struct Fragment {
+            size_t begin;
+            bool constant;
+            double value;
+            bool may_throw; // 含有除法，删掉它会丢失除零错误
+        };
+
+        double apply(OpCode op, double lhs, double rhs) {
+            switch (op) {
+                case OpCode::ADD: return lhs + rhs;
+                case OpCode::SUB: return lhs - rhs;
+                case OpCode::MUL: return lhs * rhs;
+                default: return lhs / rhs;
+            }
+        }
+
+        bool is_integral(double value) {
+            return IntegerArithmetic::from_double(value).is_integer;
+        }
+
+        // 折叠结果要与整数模式（numeric.h）在求值时得到的值一致：
+        // 绝对值不小于 2^53 的整数结果在 double 中可能已经舍入，而整数模式会精确计算；
+        // 有非整数操作数时整数模式的结果始终是 double，即使数值是整数（如 3.5 * 2）也不能折叠成整数常量
+        bool foldable(double lhs, double rhs, double value) {
+            if (std::abs(value) >= 0x1p53 && value == std::trunc(value)) return false;
+            return !is_integral(value) || (is_integral(lhs) && is_integral(rhs));
+        }
+
+        bool is(const Fragment& fragment, double value) {
+            return fragment.constant && fragment.value == value;
+        }
+
+        bool is_positive_zero(const Fragment& fragment) {
+            return is(fragment, 0.0) && !std::signbit(fragment.value);
+        }
+
+        // 去掉未再引用的常量和变量，并重新计算最大栈深度
+        void compact(Bytecode& bytecode) {
+            constexpr auto kUnused = static_cast<std::uint32_t>(-1);
+            const std::vector<double> constants = std::move(bytecode.constants);
+            const std::vector<std::string> variables = std::move(bytecode.variables);
+            std::vector<std::uint32_t> variable_map(variables.size(), kUnused);
+            bytecode.constants.clear();
+            bytecode.variables.clear();
+            size_t depth = 0;
+            bytecode.max_stack = 0;
+            for (auto& instruction : bytecode.code) {
+                if (instruction.op == OpCode::PUSH_CONST) {
+                    double value = constants[instruction.operand];
+                    instruction.operand = static_cast<std::uint32_t>(bytecode.constants.size());
+                    bytecode.constants.push_back(value);
+                    ++depth;
+                } else if (instruction.op == OpCode::LOAD_VAR) {
+                    auto& slot = variable_map[instruction.operand];
+                    if (slot == kUnused) {
+                        slot = static_cast<std::uint32_t>(bytecode.variables.size());
+                        bytecode.variables.push_back(variables[instruction.operand]);
+                    }
+                    instruction.operand = slot;
+                    ++depth;
+                } else if (instruction.op == OpCode::LOAD_TEMP) {
+                    ++depth;
+                } else if (instruction.op != OpCode::STORE_TEMP && instruction.op != OpCode::NEG) {
+                    --depth;
+                }
+                if (depth > bytecode.max_stack) bytecode.max_stack = depth;
+            }
+        }
+    }
+
+    BytecodeOptimizer::BytecodeOptimizer(OptimizerOptions options) : options_(options) {}
+
+    OptimizationStats BytecodeOptimizer::optimize(Bytecode& bytecode) const {
+        OptimizationStats stats;
+        stats.nodes_before = bytecode.code.size();
+        stats.nodes_after = bytecode.code.size();
+        if (bytecode.temp_count > 0) return stats; // 已经做过公共子表达式消除
+
+        // 折叠出的新常量先放在原常量池后面，最后统一压缩
+        std::vector<double> constants = bytecode.constants;
+        std::vector<Instruction> code;
+        std::vector<size_t> positions;
+        code.reserve(bytecode.code.size());
+        positions.reserve(bytecode.code.size());
+        std::vector<Fragment> stack;
+
+        auto erase = [&](size_t begin, size_t end) {
+            code.erase(code.begin() + begin, code.begin() + end);
+            positions.erase(positions.begin() + begin, positions.begin() + end);
+        };
+        auto emit_constant = [&](size_t begin, double value, size_t position) {
+            erase(begin, code.size());
+            code.push_back({OpCode::PUSH_CONST, static_cast<std::uint32_t>(constants.size())});
+            positions.push_back(position);
+            constants.push_back(value);
+            stack.push_back({begin, true, value, false});
+        };
+
+        for (size_t pc = 0; pc < bytecode.code.size(); ++pc) {
+            const Instruction instruction = bytecode.code[pc];
+            const size_t position = bytecode.positions[pc];
+            if (instruction.op == OpCode::PUSH_CONST || instruction.op == OpCode::LOAD_VAR) {
+                bool constant = instruction.op == OpCode::PUSH_CONST;
+                double value = constant ? bytecode.constants[instruction.operand] : 0.0;
+                stack.push_back({code.size(), constant, value, false});
+                code.push_back(instruction);
+                positions.push_back(position);
+                continue;
+            }
+
+            if (instruction.op == OpCode::NEG) {
+                Fragment operand = stack.back();
+                stack.pop_back();
+                if (options_.fold_constants && operand.constant) {
+                    emit_constant(operand.begin, -operand.value, position);
+                } else {
+                    code.push_back(instruction);
+                    positions.push_back(position);
+                    stack.push_back({operand.begin, false, 0.0, operand.may_throw});
+                }
+                continue;
+            }
+
+            Fragment rhs = stack.back();
+            stack.pop_back();
+            Fragment lhs = stack.back();
+            stack.pop_back();
+            const OpCode op = instruction.op;
+
+            if (options_.fold_constants && lhs.constant && rhs.constant && !(op == OpCode::DIV && rhs.value == 0)) {
+                const double value = apply(op, lhs.value, rhs.value);
+                if (foldable(lhs.value, rhs.value, value)) {
+                    emit_constant(lhs.begin, value, position);
+                    continue;
+                }
+            }
+
+            bool drop_rhs = false;
+            bool drop_lhs = false;
+            if (options_.simplify_identities) {
+                drop_rhs = ((op == OpCode::MUL || op == OpCode::DIV) && is(rhs, 1.0)) ||
+                           (op == OpCode::SUB && is_positive_zero(rhs));
+                drop_lhs = op == OpCode::MUL && is(lhs, 1.0);
+            }
+            if (options_.unsafe_identities && !drop_rhs && !drop_lhs) {
+                if (op == OpCode::ADD) {
+                    drop_rhs = is(rhs, 0.0);
+                    drop_lhs = !drop_rhs && is(lhs, 0.0);
+                } else if (op == OpCode::MUL && ((is(rhs, 0.0) && !lhs.may_throw) || (is(lhs, 0.0) && !rhs.may_throw))) {
+                    emit_constant(lhs.begin, 0.0, position);
+                    continue;
+                }
+            }
+
+            if (drop_rhs) {
+                erase(rhs.begin, code.size());
+                stack.push_back(lhs);
+            } else if (drop_lhs) {
+                erase(lhs.begin, rhs.begin);
+                rhs.begin = lhs.begin;
+                stack.push_back(rhs);
+            } else {
+                code.push_back(instruction);
+                positions.push_back(position);
+                stack.push_back({lhs.begin, false, 0.0, lhs.may_throw || rhs.may_throw || op == OpCode::DIV});
+            }
+        }
+
+        bytecode.code = std::move(code);
+        bytecode.positions = std::move(positions);
+        bytecode.constants = std::move(constants);
+        if (options_.eliminate_common_subexpressions) {
+            ExpressionDag dag(bytecode);
+            if (dag.shared_count() > 0) dag.emit(bytecode);
+        }
+        compact(bytecode);
+
+        stats.temporaries = bytecode.temp_count;
+        stats.nodes_after = bytecode.code.size() - bytecode.temp_count; // 每个临时槽位恰好写入一次
+        for (const auto& instruction : bytecode.code) {
+            if (instruction.op == OpCode::LOAD_TEMP) --stats.nodes_after;
+        }
+        return stats;
+    }
+
+} // namespace exprcalc
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef EXPRCALC_OPTIMIZER_H
+#define EXPRCALC_OPTIMIZER_H
+
+#include "bytecode.h"
+
+namespace exprcalc {
+
+    struct OptimizerOptions {
+        bool fold_constants = true;      // 只含常量的子表达式在编译期算好
+        bool simplify_identities = true; // x*1、1*x、x/1、x-0：对任何 IEEE 值（NaN、无穷、-0）都不改变结果
+        bool unsafe_identities = false;  // x+0、0+x（-0 + 0 得 +0）与 x*0、0*x（NaN、无穷、符号会变）
+        bool eliminate_common_subexpressions = true; // 相同子表达式只计算一次
+    };
+
+    struct OptimizationStats {
+        size_t nodes_before = 0;
+        size_t nodes_after = 0;  // 不含临时槽位的读写指令
+        size_t temporaries = 0;  // 被复用的公共子表达式个数
+        size_t removed() const { return nodes_before - nodes_after; }
+    };
+
+    // 字节码上的常量折叠、代数化简和公共子表达式消除。除以常量 0 的运算保留到运行时，错误信息和位置不变
+    class BytecodeOptimizer {
+    public:
+        explicit BytecodeOptimizer(OptimizerOptions options = {});
+        OptimizationStats optimize(Bytecode& bytecode) const;
+
+    private:
+        OptimizerOptions options_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_OPTIMIZER_H
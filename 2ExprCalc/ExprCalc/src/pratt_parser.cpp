@@ -0,0 +1,126 @@
+#include "pratt_parser.h"
+#include "error.h"
+
+namespace exprcalc {
+
+    PrattParser::PrattParser(std::string_view input)
+        : lexer_(input), current_(TokenType::END, {}, 0), last_position_(0), nesting_(0), depth_(0),
+          lexer_failed_(false), extra_operands_(false) {}
+
+    Bytecode PrattParser::parse() {
+        try {
+            advance();
+            parse_expression(0);
+            if (current_.type == TokenType::RIGHT_PAREN) {
+                throw CalculationError("Mismatched parentheses", current_.position);
+            }
+            if (current_.type != TokenType::END) {
+                throw CalculationError("Invalid token in RPN", current_.position);
+            }
+        } catch (const CalculationError&) {
+            // 先分词再解析的前端总是先报告词法错误，这里把剩余输入扫完以保持一致
+            if (!lexer_failed_) {
+                while (lexer_.next().type != TokenType::END) {}
+            }
+            throw;
+        }
+        if (extra_operands_) {
+            throw CalculationError("Invalid RPN expression: too many operands", 0);
+        }
+        return std::move(bytecode_);
+    }
+
+    void PrattParser::advance() {
+        try {
+            current_ = lexer_.next();
+        } catch (const CalculationError&) {
+            lexer_failed_ = true;
+            throw;
+        }
+        if (current_.type != TokenType::END) last_position_ = current_.position;
+    }
+
+    void PrattParser::parse_expression(int min_precedence) {
+        if (++nesting_ > kMaxNesting) {
+            throw CalculationError("Expression nested too deeply", current_.position);
+        }
+        parse_operand();
+
+        while (true) {
+            if (current_.type == TokenType::LEFT_PAREN) {
+                // 与 ShuntingYard 一致：继续解析，最后按多余操作数报错
+                extra_operands_ = true;
+                parse_operand();
+                continue;
+            }
+            if (current_.type != TokenType::OPERATOR) break;
+
+            const OperatorInfo& info = operator_info(current_.op);
+            if (info.precedence < min_precedence) break;
+            const size_t position = current_.position;
+            advance();
+            if (info.arity == 1) {
+                emit(info.opcode, 0, position, 0); // 后缀运算符
+                continue;
+            }
+            parse_expression(info.associativity == Associativity::LEFT ? info.precedence + 1 : info.precedence);
+            emit(info.opcode, 0, position, -1);
+        }
+        --nesting_;
+    }
+
+    void PrattParser::parse_operand() {
+        const Token token = current_;
+        switch (token.type) {
+            case TokenType::NUMBER:
+                emit(OpCode::PUSH_CONST, static_cast<std::uint32_t>(bytecode_.constants.size()), token.position, 1);
+                bytecode_.constants.push_back(token.number);
+                advance();
+                return;
+
+            case TokenType::VARIABLE:
+                emit(OpCode::LOAD_VAR, BytecodeCompiler::variable_slot(bytecode_, token.value), token.position, 1);
+                advance();
+                return;
+
+            case TokenType::LEFT_PAREN:
+                open_parens_.push_back(token.position);
+                advance();
+                parse_expression(0);
+                if (current_.type == TokenType::END) {
+                    throw CalculationError("Mismatched parentheses", open_parens_.back());
+                }
+                if (current_.type != TokenType::RIGHT_PAREN) {
+                    throw CalculationError("Invalid token in RPN", current_.position);
+                }
+                open_parens_.pop_back();
+                advance();
+                return;
+
+            case TokenType::OPERATOR: {
+                const OperatorInfo& info = operator_info(token.op);
+                if (info.prefix_precedence == 0) break;
+                advance();
+                parse_expression(info.prefix_precedence);
+                emit(info.prefix_opcode, 0, token.position, 0);
+                return;
+            }
+
+            case TokenType::END:
+                if (!open_parens_.empty()) throw CalculationError("Mismatched parentheses", open_parens_.back());
+                throw CalculationError("Invalid token in RPN", last_position_);
+
+            case TokenType::RIGHT_PAREN:
+                break;
+        }
+        throw CalculationError("Invalid token in RPN", token.position);
+    }
+
+    void PrattParser::emit(OpCode op, std::uint32_t operand, size_t position, int stack_effect) {
+        bytecode_.code.push_back({op, operand});
+        bytecode_.positions.push_back(position);
+        depth_ += stack_effect;
+        if (depth_ > bytecode_.max_stack) bytecode_.max_stack = depth_;
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,41 @@
+#ifndef EXPRCALC_PRATT_PARSER_H
+#define EXPRCALC_PRATT_PARSER_H
+
+#include "bytecode.h"
+#include "lexer.h"
+#include "token.h"
+#include <string_view>
+#include <vector>
+
+namespace exprcalc {
+
+    // Pratt（优先级爬升）解析器：边从词法分析器拉取标记边直接生成字节码，不产生标记数组和逆波兰序列。
+    // 前缀、后缀和右结合都由运算符表驱动；目前表中只有前缀负号用到前缀规则。
+    // 对 ShuntingYard 也能接受的输入，生成的字节码和报错信息、位置都与之相同
+    class PrattParser {
+    public:
+        static constexpr size_t kMaxNesting = 2000; // 递归下降的嵌套上限，超出时报错而不是耗尽调用栈
+
+        explicit PrattParser(std::string_view input);
+        Bytecode parse();
+
+    private:
+        Lexer lexer_;
+        Token current_;
+        size_t last_position_;            // 最后一个标记的位置，结尾缺少操作数时报在这里
+        std::vector<size_t> open_parens_; // 尚未闭合的左括号位置
+        size_t nesting_;
+        size_t depth_;                    // 生成代码的当前栈深度
+        bool lexer_failed_;
+        bool extra_operands_;             // 出现了 "1 (2)" 这类相邻的操作数
+        Bytecode bytecode_;
+
+        void advance();
+        void parse_expression(int min_precedence);
+        void parse_operand();
+        void emit(OpCode op, std::uint32_t operand, size_t position, int stack_effect);
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_PRATT_PARSER_H
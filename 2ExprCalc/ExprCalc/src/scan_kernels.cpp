@@ -0,0 +1,111 @@
+#include "scan_kernels.h"
+#include "char_class.h"
+#include <cstring>
+
+#if defined(EXPRCALC_X86)
+#include <immintrin.h>
+#endif
+
+namespace exprcalc {
+
+    namespace {
+
+        // ---------- 标量回退：每字节查一次字符类别表 ----------
+
+        CharMasks classify_scalar(const char* p, size_t n) {
+            CharMasks masks{0, 0, 0};
+            for (size_t i = 0; i < n; ++i) {
+                const std::uint8_t classes = char_info(p[i]).classes;
+                masks.space |= std::uint64_t{(classes & CHAR_SPACE) != 0} << i;
+                masks.number |= std::uint64_t{(classes & (CHAR_DIGIT | CHAR_NUMBER_PART)) != 0} << i;
+                masks.ident |= std::uint64_t{(classes & (CHAR_DIGIT | CHAR_ALPHA)) != 0} << i;
+            }
+            return masks;
+        }
+
+#if defined(EXPRCALC_X86)
+
+        // 不足一个块时补 0 再走整块路径，'\0' 不属于任何类别
+        template <CharMasks (*Block)(const char*)>
+        CharMasks classify_padded(const char* p, size_t n) {
+            if (n == kScanBlock) return Block(p);
+            char padded[kScanBlock] = {};
+            std::memcpy(padded, p, n);
+            return Block(padded);
+        }
+
+        // ---------- SSE2：每次 16 字节 ----------
+
+        // 无符号比较 lo <= x <= lo + width：x - lo 回绕后不超过 width
+        EXPRCALC_TARGET("sse2")
+        inline __m128i in_range_sse2(__m128i x, char lo, char width) {
+            const __m128i offset = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+            return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(width)), offset);
+        }
+
+        EXPRCALC_TARGET("sse2")
+        CharMasks classify_block_sse2(const char* p) {
+            CharMasks masks{0, 0, 0};
+            for (size_t i = 0; i < kScanBlock; i += 16) {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                const __m128i digit = in_range_sse2(x, '0', 9);
+                const __m128i alpha = in_range_sse2(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 25);
+                const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), in_range_sse2(x, '\t', 4));
+                const __m128i number = _mm_or_si128(digit, _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('.')),
+                                                                        _mm_cmpeq_epi8(x, _mm_set1_epi8('_'))));
+                masks.space |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(space))} << i;
+                masks.number |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(number))} << i;
+                masks.ident |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_or_si128(digit, alpha)))} << i;
+            }
+            return masks;
+        }
+
+        // ---------- AVX2：每次 32 字节 ----------
+
+        EXPRCALC_TARGET("avx2")
+        inline __m256i in_range_avx2(__m256i x, char lo, char width) {
+            const __m256i offset = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(width)), offset);
+        }
+
+        EXPRCALC_TARGET("avx2")
+        CharMasks classify_block_avx2(const char* p) {
+            CharMasks masks{0, 0, 0};
+            for (size_t i = 0; i < kScanBlock; i += 32) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                const __m256i digit = in_range_avx2(x, '0', 9);
+                const __m256i alpha = in_range_avx2(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 25);
+                const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                                                      in_range_avx2(x, '\t', 4));
+                const __m256i number = _mm256_or_si256(digit, _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('.')),
+                                                                              _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))));
+                masks.space |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(space))} << i;
+                masks.number |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(number))} << i;
+                masks.ident |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)))} << i;
+            }
+            return masks;
+        }
+
+#endif // EXPRCALC_X86
+
+    } // namespace
+
+    ClassifyKernel classify_kernel_for(SimdLevel level) {
+        const SimdLevel supported = detect_simd_level();
+        if (level > supported) level = supported;
+        switch (level) {
+#if defined(EXPRCALC_X86)
+            case SimdLevel::AVX512:
+            case SimdLevel::AVX2: return classify_padded<classify_block_avx2>;
+            case SimdLevel::SSE2: return classify_padded<classify_block_sse2>;
+#endif
+            default: return classify_scalar;
+        }
+    }
+
+    ClassifyKernel best_classify_kernel() {
+        static const ClassifyKernel kernel = classify_kernel_for(detect_simd_level());
+        return kernel;
+    }
+
+} // namespace exprcalc
\ No newline at end of file
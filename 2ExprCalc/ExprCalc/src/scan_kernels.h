@@ -0,0 +1,28 @@
+#ifndef EXPRCALC_SCAN_KERNELS_H
+#define EXPRCALC_SCAN_KERNELS_H
+
+#include "cpu_features.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace exprcalc {
+
+    constexpr size_t kScanBlock = 64; // 每次分类的字节数，恰好填满一个 64 位掩码
+
+    // 一个块中各字符类别的位图，第 i 位对应块内第 i 个字节；块外（超出 n）的位总是 0
+    struct CharMasks {
+        std::uint64_t space;  // 空白：' '、'\t'、'\n'、'\v'、'\f'、'\r'（与 C locale 的 isspace 相同）
+        std::uint64_t number; // 十进制数字、'.' 和数字分隔符 '_'
+        std::uint64_t ident;  // ASCII 字母和数字
+    };
+
+    // 对 p[0, n) 分类，n <= kScanBlock
+    using ClassifyKernel = CharMasks (*)(const char* p, size_t n);
+
+    // 返回不超过 level 且当前 CPU 支持的最高一级内核；AVX-512 使用 AVX2 内核
+    ClassifyKernel classify_kernel_for(SimdLevel level);
+    ClassifyKernel best_classify_kernel();
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_SCAN_KERNELS_H
\ No newline at end of file
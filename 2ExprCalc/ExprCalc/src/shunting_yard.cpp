@@ -5,14 +5,7 @@
 
 namespace exprcalc {
 
-ShuntingYard::ShuntingYard(const std::vector<Token>& tokens) : tokens_(tokens) {
-    precedence_ = {
-        {"+", 1},
-        {"-", 1},
-        {"*", 2},
-        {"/", 2}
-    };
-}
+ShuntingYard::ShuntingYard(const std::vector<Token>& tokens) : tokens_(tokens) {}
 
 std::vector<Token> ShuntingYard::to_rpn() {
     std::vector<Token> output;
@@ -36,7 +29,7 @@ std::vector<Token> ShuntingYard::to_rpn() {
                 }
                 while (!operators.empty() &&
                        operators.top().type != TokenType::LEFT_PAREN &&
-                       get_precedence(operators.top().value) >= get_precedence(token.value)) {
+                       pops_before(operators.top(), token)) {
                     output.push_back(operators.top());
                     operators.pop();
                 }
@@ -63,6 +56,9 @@ std::vector<Token> ShuntingYard::to_rpn() {
                 operators.pop(); // 移除左括号
                 expect_operand = false; // 右括号后期待运算符或结束
                 break;
+
+            case TokenType::END:
+                break;
         }
     }
 
@@ -81,13 +77,11 @@ std::vector<Token> ShuntingYard::to_rpn() {
     return output;
 }
 
-bool ShuntingYard::is_operator(const std::string& value) const {
-    return precedence_.find(value) != precedence_.end();
-}
-
-int ShuntingYard::get_precedence(const std::string& op) const {
-    auto it = precedence_.find(op);
-    return it != precedence_.end() ? it->second : 0;
+bool ShuntingYard::pops_before(const Token& top, const Token& incoming) {
+    const OperatorInfo& stacked = operator_info(top.op);
+    const OperatorInfo& current = operator_info(incoming.op);
+    if (stacked.precedence != current.precedence) return stacked.precedence > current.precedence;
+    return current.associativity == Associativity::LEFT;
 }
 
 } // namespace exprcalc
\ No newline at end of file
@@ -4,7 +4,6 @@
 #include "token.h"
 #include <vector>
 #include <stack>
-#include <map>
 
 namespace exprcalc {
 
@@ -14,10 +13,9 @@ namespace exprcalc {
         std::vector<Token> to_rpn();
 
     private:
-        std::vector<Token> tokens_;
-        std::map<std::string, int> precedence_; // 运算符优先级
-        bool is_operator(const std::string& value) const;
-        int get_precedence(const std::string& op) const;
+        const std::vector<Token>& tokens_; // 只借用，调用方保证 to_rpn 期间有效
+        // 栈顶运算符是否应先于 incoming 出栈（由运算符表中的优先级和结合性决定）
+        static bool pops_before(const Token& top, const Token& incoming);
     };
 
 } // namespace exprcalc
@@ -0,0 +1,167 @@
+#include "simd_kernels.h"
+#include <bit>
+
+#if defined(EXPRCALC_X86)
+#include <immintrin.h>
+#endif
+
+namespace exprcalc {
+
+    namespace {
+
+        // ---------- 标量回退 ----------
+
+        void add_scalar(const double* a, const double* b, double* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+        }
+
+        void sub_scalar(const double* a, const double* b, double* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+        }
+
+        void mul_scalar(const double* a, const double* b, double* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+        }
+
+        size_t div_scalar(const double* a, const double* b, double* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                if (b[i] == 0.0) return i;
+                out[i] = a[i] / b[i];
+            }
+            return n;
+        }
+
+        constexpr KernelTable kScalarKernels{SimdLevel::SCALAR, add_scalar, sub_scalar, mul_scalar, div_scalar};
+
+#if defined(EXPRCALC_X86)
+
+        // ---------- SSE2：每次 2 个 double ----------
+
+#define EXPRCALC_SSE2_BINARY(name, intrinsic)                                          \
+        EXPRCALC_TARGET("sse2")                                                        \
+        void name(const double* a, const double* b, double* out, size_t n) {           \
+            size_t i = 0;                                                              \
+            for (; i + 2 <= n; i += 2) {                                               \
+                _mm_storeu_pd(out + i, intrinsic(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i))); \
+            }                                                                          \
+            for (; i < n; ++i) _mm_store_sd(out + i, intrinsic(_mm_load_sd(a + i), _mm_load_sd(b + i))); \
+        }
+
+        EXPRCALC_SSE2_BINARY(add_sse2, _mm_add_pd)
+        EXPRCALC_SSE2_BINARY(sub_sse2, _mm_sub_pd)
+        EXPRCALC_SSE2_BINARY(mul_sse2, _mm_mul_pd)
+#undef EXPRCALC_SSE2_BINARY
+
+        EXPRCALC_TARGET("sse2")
+        size_t div_sse2(const double* a, const double* b, double* out, size_t n) {
+            const __m128d zero = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                __m128d divisor = _mm_loadu_pd(b + i);
+                int mask = _mm_movemask_pd(_mm_cmpeq_pd(divisor, zero));
+                if (mask != 0) return i + std::countr_zero(static_cast<unsigned>(mask));
+                _mm_storeu_pd(out + i, _mm_div_pd(_mm_loadu_pd(a + i), divisor));
+            }
+            return i + div_scalar(a + i, b + i, out + i, n - i);
+        }
+
+        constexpr KernelTable kSse2Kernels{SimdLevel::SSE2, add_sse2, sub_sse2, mul_sse2, div_sse2};
+
+        // ---------- AVX2：每次 4 个 double ----------
+
+#define EXPRCALC_AVX2_BINARY(name, intrinsic, tail)                                     \
+        EXPRCALC_TARGET("avx2")                                                         \
+        void name(const double* a, const double* b, double* out, size_t n) {            \
+            size_t i = 0;                                                               \
+            for (; i + 4 <= n; i += 4) {                                                \
+                _mm256_storeu_pd(out + i, intrinsic(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))); \
+            }                                                                           \
+            tail(a + i, b + i, out + i, n - i);                                         \
+        }
+
+        EXPRCALC_AVX2_BINARY(add_avx2, _mm256_add_pd, add_sse2)
+        EXPRCALC_AVX2_BINARY(sub_avx2, _mm256_sub_pd, sub_sse2)
+        EXPRCALC_AVX2_BINARY(mul_avx2, _mm256_mul_pd, mul_sse2)
+#undef EXPRCALC_AVX2_BINARY
+
+        EXPRCALC_TARGET("avx2")
+        size_t div_avx2(const double* a, const double* b, double* out, size_t n) {
+            const __m256d zero = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256d divisor = _mm256_loadu_pd(b + i);
+                int mask = _mm256_movemask_pd(_mm256_cmp_pd(divisor, zero, _CMP_EQ_OQ));
+                if (mask != 0) return i + std::countr_zero(static_cast<unsigned>(mask));
+                _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(a + i), divisor));
+            }
+            return i + div_sse2(a + i, b + i, out + i, n - i);
+        }
+
+        constexpr KernelTable kAvx2Kernels{SimdLevel::AVX2, add_avx2, sub_avx2, mul_avx2, div_avx2};
+
+        // ---------- AVX-512：每次 8 个 double，尾部用掩码加载，不需要标量循环 ----------
+
+#define EXPRCALC_AVX512_BINARY(name, intrinsic)                                         \
+        EXPRCALC_TARGET("avx512f")                                                      \
+        void name(const double* a, const double* b, double* out, size_t n) {            \
+            size_t i = 0;                                                               \
+            for (; i + 8 <= n; i += 8) {                                                \
+                _mm512_storeu_pd(out + i, intrinsic(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))); \
+            }                                                                           \
+            if (i < n) {                                                                \
+                const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);        \
+                __m512d x = _mm512_maskz_loadu_pd(tail, a + i);                         \
+                __m512d y = _mm512_maskz_loadu_pd(tail, b + i);                         \
+                _mm512_mask_storeu_pd(out + i, tail, intrinsic(x, y));                  \
+            }                                                                           \
+        }
+
+        EXPRCALC_AVX512_BINARY(add_avx512, _mm512_add_pd)
+        EXPRCALC_AVX512_BINARY(sub_avx512, _mm512_sub_pd)
+        EXPRCALC_AVX512_BINARY(mul_avx512, _mm512_mul_pd)
+#undef EXPRCALC_AVX512_BINARY
+
+        EXPRCALC_TARGET("avx512f")
+        size_t div_avx512(const double* a, const double* b, double* out, size_t n) {
+            const __m512d zero = _mm512_setzero_pd();
+            size_t i = 0;
+            while (i < n) {
+                const size_t remaining = n - i;
+                const __mmask8 lanes = remaining >= 8 ? static_cast<__mmask8>(0xff)
+                                                      : static_cast<__mmask8>((1u << remaining) - 1);
+                // 未加载的尾部通道补 1，不会被误判为除数为 0
+                __m512d divisor = _mm512_mask_loadu_pd(_mm512_set1_pd(1.0), lanes, b + i);
+                __mmask8 zeros = _mm512_cmp_pd_mask(divisor, zero, _CMP_EQ_OQ);
+                if (zeros != 0) return i + std::countr_zero(static_cast<unsigned>(zeros));
+                __m512d dividend = _mm512_maskz_loadu_pd(lanes, a + i);
+                _mm512_mask_storeu_pd(out + i, lanes, _mm512_div_pd(dividend, divisor));
+                i += 8;
+            }
+            return n;
+        }
+
+        constexpr KernelTable kAvx512Kernels{SimdLevel::AVX512, add_avx512, sub_avx512, mul_avx512, div_avx512};
+
+#endif // EXPRCALC_X86
+
+    } // namespace
+
+    const KernelTable& kernels_for(SimdLevel level) {
+        const SimdLevel supported = detect_simd_level();
+        if (level > supported) level = supported;
+        switch (level) {
+#if defined(EXPRCALC_X86)
+            case SimdLevel::AVX512: return kAvx512Kernels;
+            case SimdLevel::AVX2: return kAvx2Kernels;
+            case SimdLevel::SSE2: return kSse2Kernels;
+#endif
+            default: return kScalarKernels;
+        }
+    }
+
+    const KernelTable& best_kernels() {
+        static const KernelTable& kernels = kernels_for(detect_simd_level());
+        return kernels;
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,28 @@
+#ifndef EXPRCALC_SIMD_KERNELS_H
+#define EXPRCALC_SIMD_KERNELS_H
+
+#include "cpu_features.h"
+#include <cstddef>
+
+namespace exprcalc {
+
+    // out[i] = a[i] op b[i]，out 可以与 a 或 b 指向同一块内存
+    using BinaryKernel = void (*)(const double* a, const double* b, double* out, size_t n);
+    // 除法内核在同一遍循环里检查除数，返回第一个为 0 的下标，没有则返回 n
+    using DivideKernel = size_t (*)(const double* a, const double* b, double* out, size_t n);
+
+    struct KernelTable {
+        SimdLevel level;
+        BinaryKernel add;
+        BinaryKernel sub;
+        BinaryKernel mul;
+        DivideKernel div;
+    };
+
+    // 返回不超过 level 且当前 CPU 支持的最高一级内核
+    const KernelTable& kernels_for(SimdLevel level);
+    const KernelTable& best_kernels();
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_SIMD_KERNELS_H
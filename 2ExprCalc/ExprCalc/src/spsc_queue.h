@@ -0,0 +1,62 @@
+#ifndef EXPRCALC_SPSC_QUEUE_H
+#define EXPRCALC_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace exprcalc {
+
+    // 有界单生产者单消费者环形队列，无锁：
+    // 两端各自只写自己的下标，队列满/空时在对方的下标上 atomic::wait
+    template <typename T>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+            slots_.resize(size);
+            mask_ = static_cast<std::uint32_t>(size - 1);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // 只能由生产者线程调用，队列满时阻塞
+        void push(T value) {
+            std::uint32_t tail = tail_.load(std::memory_order_relaxed);
+            std::uint32_t head = head_.load(std::memory_order_acquire);
+            while (tail - head > mask_) {
+                head_.wait(head, std::memory_order_acquire);
+                head = head_.load(std::memory_order_acquire);
+            }
+            slots_[tail & mask_] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            tail_.notify_one();
+        }
+
+        // 只能由消费者线程调用，队列空时阻塞
+        T pop() {
+            std::uint32_t head = head_.load(std::memory_order_relaxed);
+            std::uint32_t tail = tail_.load(std::memory_order_acquire);
+            while (tail == head) {
+                tail_.wait(tail, std::memory_order_acquire);
+                tail = tail_.load(std::memory_order_acquire);
+            }
+            T value = std::move(slots_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            head_.notify_one();
+            return value;
+        }
+
+    private:
+        std::vector<T> slots_;
+        std::uint32_t mask_;
+        alignas(64) std::atomic<std::uint32_t> head_{0}; // 消费者下标
+        alignas(64) std::atomic<std::uint32_t> tail_{0}; // 生产者下标
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_SPSC_QUEUE_H
@@ -0,0 +1,30 @@
+#ifndef EXPRCALC_STACK_BUFFER_H
+#define EXPRCALC_STACK_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+
+namespace exprcalc {
+
+    // 小容量时使用栈上数组，超出 N 才退回到堆分配，避免热路径上的内存分配
+    template <typename T, std::size_t N>
+    class StackBuffer {
+    public:
+        explicit StackBuffer(std::size_t size)
+            : heap_(size > N ? std::make_unique<T[]>(size) : nullptr),
+              data_(size > N ? heap_.get() : inline_) {}
+        StackBuffer(const StackBuffer&) = delete;
+        StackBuffer& operator=(const StackBuffer&) = delete;
+
+        T* data() { return data_; }
+        T& operator[](std::size_t i) { return data_[i]; }
+
+    private:
+        T inline_[N];
+        std::unique_ptr<T[]> heap_;
+        T* data_;
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_STACK_BUFFER_H
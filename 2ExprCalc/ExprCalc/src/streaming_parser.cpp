@@ -0,0 +1,125 @@
+#include "streaming_parser.h"
+#include "error.h"
+
+namespace exprcalc {
+
+    StreamingParser::StreamingParser(std::string_view input)
+        : lexer_(input), last_position_(0), depth_(0), lexer_failed_(false) {}
+
+    Bytecode StreamingParser::parse() {
+        try {
+            run();
+        } catch (const CalculationError&) {
+            // 先分词再解析的前端总是先报告词法错误，这里把剩余输入扫完以保持一致
+            if (!lexer_failed_) {
+                while (lexer_.next().type != TokenType::END) {}
+            }
+            throw;
+        }
+        // 与 BytecodeCompiler 相同：相邻的操作数（如 "1 (2)"）在这里才被发现
+        if (depth_ != 1) {
+            throw CalculationError("Invalid RPN expression: too many operands", 0);
+        }
+        return std::move(bytecode_);
+    }
+
+    Token StreamingParser::next() {
+        try {
+            Token token = lexer_.next();
+            if (token.type != TokenType::END) last_position_ = token.position;
+            return token;
+        } catch (const CalculationError&) {
+            lexer_failed_ = true;
+            throw;
+        }
+    }
+
+    void StreamingParser::run() {
+        bool expect_operand = true; // 初始期待操作数
+
+        for (Token token = next(); token.type != TokenType::END; token = next()) {
+            switch (token.type) {
+                case TokenType::NUMBER:
+                    if (!expect_operand) {
+                        throw CalculationError("Invalid token in RPN", token.position);
+                    }
+                    emit(OpCode::PUSH_CONST, static_cast<std::uint32_t>(bytecode_.constants.size()), token.position, 1);
+                    bytecode_.constants.push_back(token.number);
+                    expect_operand = false;
+                    break;
+
+                case TokenType::VARIABLE:
+                    if (!expect_operand) {
+                        throw CalculationError("Invalid token in RPN", token.position);
+                    }
+                    emit(OpCode::LOAD_VAR, BytecodeCompiler::variable_slot(bytecode_, token.value), token.position, 1);
+                    expect_operand = false;
+                    break;
+
+                case TokenType::OPERATOR: {
+                    if (expect_operand) {
+                        throw CalculationError("Invalid token in RPN", token.position);
+                    }
+                    const OperatorInfo& current = operator_info(token.op);
+                    while (!operators_.empty() && !operators_.back().paren) {
+                        const OperatorInfo& stacked = operator_info(operators_.back().op);
+                        if (stacked.precedence < current.precedence) break;
+                        if (stacked.precedence == current.precedence && current.associativity != Associativity::LEFT) break;
+                        emit_operator(operators_.back());
+                        operators_.pop_back();
+                    }
+                    operators_.push_back({token.op, token.position, false});
+                    expect_operand = true;
+                    break;
+                }
+
+                case TokenType::LEFT_PAREN:
+                    operators_.push_back({Operator(), token.position, true});
+                    expect_operand = true;
+                    break;
+
+                case TokenType::RIGHT_PAREN:
+                    if (expect_operand) {
+                        throw CalculationError("Invalid token in RPN", token.position);
+                    }
+                    while (!operators_.empty() && !operators_.back().paren) {
+                        emit_operator(operators_.back());
+                        operators_.pop_back();
+                    }
+                    if (operators_.empty()) {
+                        throw CalculationError("Mismatched parentheses", token.position);
+                    }
+                    operators_.pop_back(); // 移除左括号
+                    expect_operand = false;
+                    break;
+
+                case TokenType::END:
+                    break;
+            }
+        }
+
+        while (!operators_.empty()) {
+            if (operators_.back().paren) {
+                throw CalculationError("Mismatched parentheses", operators_.back().position);
+            }
+            emit_operator(operators_.back());
+            operators_.pop_back();
+        }
+
+        if (expect_operand) {
+            throw CalculationError("Invalid token in RPN", last_position_);
+        }
+    }
+
+    void StreamingParser::emit_operator(const PendingOperator& pending) {
+        emit(operator_info(pending.op).opcode, 0, pending.position, -1);
+    }
+
+    void StreamingParser::emit(OpCode op, std::uint32_t operand, size_t position, int stack_effect) {
+        bytecode_.code.push_back({op, operand});
+        bytecode_.positions.push_back(position);
+        depth_ += stack_effect;
+        if (depth_ > bytecode_.max_stack) bytecode_.max_stack = depth_;
+    }
+
+} // namespace exprcalc
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef EXPRCALC_STREAMING_PARSER_H
+#define EXPRCALC_STREAMING_PARSER_H
+
+#include "bytecode.h"
+#include "lexer.h"
+#include "token.h"
+#include <string_view>
+#include <vector>
+
+namespace exprcalc {
+
+    // 流式前端：调度场算法直接消费 Lexer::next 拉取的标记并生成字节码。
+    // 不保存标记数组和逆波兰序列，除输出的字节码外只占用与括号/运算符嵌套深度成正比的内存，
+    // 也不递归，因此没有嵌套深度上限。接受的语法、生成的字节码和报错都与 ShuntingYard + BytecodeCompiler 相同
+    class StreamingParser {
+    public:
+        explicit StreamingParser(std::string_view input);
+        Bytecode parse();
+
+    private:
+        struct PendingOperator {
+            Operator op;
+            size_t position;
+            bool paren; // 左括号，op 无意义
+        };
+
+        Lexer lexer_;
+        std::vector<PendingOperator> operators_;
+        size_t last_position_; // 最后一个标记的位置，结尾缺少操作数时报在这里
+        size_t depth_;         // 生成代码的当前栈深度
+        bool lexer_failed_;
+        Bytecode bytecode_;
+
+        Token next();
+        void run();
+        void emit_operator(const PendingOperator& pending);
+        void emit(OpCode op, std::uint32_t operand, size_t position, int stack_effect);
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_STREAMING_PARSER_H
\ No newline at end of file
@@ -1,22 +1,53 @@
 #include "symbol_table.h"
 #include "error.h"
+#include <atomic>
 
 namespace exprcalc {
 
     void SymbolTable::set_variable(const std::string& name, double value) {
-        variables_[name] = value;
+        set(intern(name), value);
     }
 
     double SymbolTable::get_variable(const std::string& name) const {
-        auto it = variables_.find(name);
-        if (it == variables_.end()) {
+        auto ref = find(name);
+        if (!ref || !is_defined(*ref)) {
             throw CalculationError("Undefined variable: " + name, 0);
         }
-        return it->second;
+        return values_[ref->slot_];
     }
 
     bool SymbolTable::has_variable(const std::string& name) const {
-        return variables_.find(name) != variables_.end();
+        auto ref = find(name);
+        return ref && is_defined(*ref);
     }
 
-} // namespace exprcalc
\ No newline at end of file
+    VariableRef SymbolTable::intern(std::string_view name) {
+        auto it = index_.find(name);
+        if (it != index_.end()) return VariableRef(it->second);
+        size_t slot = values_.size();
+        values_.push_back(0.0);
+        defined_.push_back(0);
+        names_.emplace_back(name);
+        index_.emplace(names_.back(), slot);
+        return VariableRef(slot);
+    }
+
+    std::optional<VariableRef> SymbolTable::find(std::string_view name) const {
+        auto it = index_.find(name);
+        if (it == index_.end()) return std::nullopt;
+        return VariableRef(it->second);
+    }
+
+    double SymbolTable::get(VariableRef ref) const {
+        if (!is_defined(ref)) {
+            throw CalculationError("Undefined variable: " + names_[ref.slot_], 0);
+        }
+        return values_[ref.slot_];
+    }
+
+    std::uint64_t SymbolTable::Identity::next() {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+} // namespace exprcalc
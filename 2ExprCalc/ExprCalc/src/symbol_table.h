@@ -1,21 +1,68 @@
 #ifndef EXPRCALC_SYMBOL_TABLE_H
 #define EXPRCALC_SYMBOL_TABLE_H
 
-#include <map>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace exprcalc {
 
+    // 变量句柄：直接对应符号表中的槽位，读写时不涉及任何字符串哈希
+    class VariableRef {
+    public:
+        size_t slot() const { return slot_; }
+        bool operator==(const VariableRef& other) const = default;
+
+    private:
+        friend class SymbolTable;
+        explicit VariableRef(size_t slot) : slot_(slot) {}
+        size_t slot_;
+    };
+
+    // 变量名在第一次出现时被分配一个稠密的槽位，值按槽位连续存放；槽位只增不减
     class SymbolTable {
     public:
         void set_variable(const std::string& name, double value);
         double get_variable(const std::string& name) const;
         bool has_variable(const std::string& name) const;
 
+        VariableRef intern(std::string_view name); // 登记变量名（可以尚未赋值）并返回句柄
+        std::optional<VariableRef> find(std::string_view name) const;
+        void set(VariableRef ref, double value) { values_[ref.slot_] = value; defined_[ref.slot_] = 1; }
+        double get(VariableRef ref) const; // 未赋值时抛出 CalculationError
+        bool is_defined(VariableRef ref) const { return defined_[ref.slot_] != 0; }
+        const std::string& name(VariableRef ref) const { return names_[ref.slot_]; }
+        size_t size() const { return values_.size(); }
+
+        // 标识本表的槽位布局，用于判断 VariableRef 是否属于本表。
+        // 拷贝出的表会得到新的 id：两份拷贝之后各自登记的新变量可能占用同一个槽位
+        std::uint64_t id() const { return identity_.value; }
+
     private:
-        std::map<std::string, double> variables_;
+        struct Identity {
+            std::uint64_t value = next();
+            Identity() = default;
+            Identity(const Identity&) : value(next()) {}
+            Identity& operator=(const Identity&) { value = next(); return *this; }
+            static std::uint64_t next();
+        };
+
+        struct NameHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+        };
+
+        std::vector<double> values_;
+        std::vector<char> defined_;
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, size_t, NameHash, std::equal_to<>> index_;
+        Identity identity_;
     };
 
 } // namespace exprcalc
 
-#endif // EXPRCALC_SYMBOL_TABLE_H
\ No newline at end of file
+#endif // EXPRCALC_SYMBOL_TABLE_H
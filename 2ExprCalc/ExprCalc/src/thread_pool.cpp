@@ -0,0 +1,101 @@
+#include "thread_pool.h"
+
+namespace exprcalc {
+
+    ThreadPool::ThreadPool(size_t threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        for (size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        stopping_.store(true);
+        epoch_.fetch_add(1);
+        epoch_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+
+    size_t ThreadPool::size() const {
+        return threads_.size();
+    }
+
+    void ThreadPool::run(std::vector<Task> tasks) {
+        if (tasks.empty()) return;
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+        const size_t count = tasks.size();
+        error_ = nullptr;
+        pending_.store(count);
+
+        // 按连续区间分配给各个线程，相邻的任务尽量由同一个线程执行
+        const size_t workers = queues_.size();
+        for (size_t i = 0; i < count; ++i) {
+            WorkQueue& queue = *queues_[i * workers / count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(tasks[i]));
+        }
+        epoch_.fetch_add(1);
+        epoch_.notify_all();
+
+        for (size_t pending = pending_.load(); pending != 0; pending = pending_.load()) {
+            pending_.wait(pending);
+        }
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    void ThreadPool::worker_loop(size_t index) {
+        while (true) {
+            // 先记下 epoch 再找任务：找不到任务期间若有新提交，epoch 已变化，wait 会立即返回
+            const std::uint32_t epoch = epoch_.load();
+            Task task;
+            if (take_task(index, task)) {
+                std::exception_ptr error;
+                try {
+                    task();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                finish_task(error);
+                continue;
+            }
+            if (stopping_.load()) return;
+            epoch_.wait(epoch);
+        }
+    }
+
+    bool ThreadPool::take_task(size_t index, Task& task) {
+        {
+            WorkQueue& own = *queues_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkQueue& victim = *queues_[(index + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::finish_task(std::exception_ptr error) {
+        if (error) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) error_ = error;
+        }
+        if (pending_.fetch_sub(1) == 1) pending_.notify_all();
+    }
+
+} // namespace exprcalc
@@ -0,0 +1,53 @@
+#ifndef EXPRCALC_THREAD_POOL_H
+#define EXPRCALC_THREAD_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace exprcalc {
+
+    // 工作窃取线程池：每个工作线程有自己的任务队列，从队头取任务；
+    // 自己的队列空了以后从其他线程的队尾窃取，保证负载不均时也能跑满所有核心
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        explicit ThreadPool(size_t threads = 0); // 0 表示使用硬件线程数
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const;
+        // 提交一批任务并阻塞到全部完成；任务抛出的第一个异常会在这里重新抛出
+        void run(std::vector<Task> tasks);
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex run_mutex_;                // 串行化并发的 run 调用
+        std::atomic<std::uint32_t> epoch_{0}; // 每次提交任务或停止时递增，空闲线程在它上面等待
+        std::atomic<size_t> pending_{0};      // 尚未执行完的任务数
+        std::atomic<bool> stopping_{false};
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+
+        void worker_loop(size_t index);
+        bool take_task(size_t index, Task& task);
+        void finish_task(std::exception_ptr error);
+    };
+
+} // namespace exprcalc
+
+#endif // EXPRCALC_THREAD_POOL_H
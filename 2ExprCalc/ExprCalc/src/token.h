@@ -1,7 +1,8 @@
 #ifndef EXPRCALC_TOKEN_H
 #define EXPRCALC_TOKEN_H
 
-#include <string>
+#include "operators.h"
+#include <string_view>
 
 namespace exprcalc {
 
@@ -10,15 +11,21 @@ namespace exprcalc {
         OPERATOR,    // 运算符（+、-、*、/）
         VARIABLE,    // 变量（例如 x、y）
         LEFT_PAREN,  // 左括号 (
-        RIGHT_PAREN  // 右括号 )
+        RIGHT_PAREN, // 右括号 )
+        END          // 输入结束，只由 Lexer::next 返回，不出现在 tokenize 的结果中
     };
 
     struct Token {
         TokenType type;
-        std::string value; // 存储具体值（如 "3.14"、"+"、"x"）
-        size_t position;   // 标记在输入中的位置，用于错误报告
+        std::string_view value; // 指向输入中的片段（如 "3.14"、"+"、"x"），不拷贝，输入必须比 Token 活得久
+        size_t position;        // 标记在输入中的位置，用于错误报告
+        double number;          // NUMBER 在词法分析时就转换好的数值，其他类型为 0
+        Operator op;            // OPERATOR 的运算符种类，其他类型无意义
 
-        Token(TokenType t, std::string v, size_t pos) : type(t), value(std::move(v)), position(pos) {}
+        Token(TokenType t, std::string_view v, size_t pos, double num = 0.0)
+            : type(t), value(v), position(pos), number(num), op() {}
+        Token(TokenType t, std::string_view v, size_t pos, Operator o)
+            : type(t), value(v), position(pos), number(0.0), op(o) {}
     };
 
 } // namespace exprcalc
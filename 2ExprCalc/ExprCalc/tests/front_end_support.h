@@ -0,0 +1,64 @@
+#ifndef EXPRCALC_TESTS_FRONT_END_SUPPORT_H
+#define EXPRCALC_TESTS_FRONT_END_SUPPORT_H
+
+#include "../src/bytecode.h"
+#include "../src/error.h"
+#include "../src/lexer.h"
+#include "../src/shunting_yard.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// 各前端（语法树、Pratt、流式）与逆波兰路径对照测试共用的辅助函数
+namespace exprcalc::test {
+
+    // 参照路径：词法分析 → 调度场 → 逆波兰编译，不做优化
+    inline Bytecode compile_rpn(const std::string& expression) {
+        auto tokens = Lexer(expression).tokenize();
+        ShuntingYard shunting_yard(tokens);
+        auto rpn = shunting_yard.to_rpn();
+        return BytecodeCompiler(rpn).compile();
+    }
+
+    inline void expect_same_bytecode(const Bytecode& actual, const Bytecode& expected) {
+        ASSERT_EQ(actual.code.size(), expected.code.size());
+        for (size_t i = 0; i < actual.code.size(); ++i) {
+            EXPECT_EQ(actual.code[i].op, expected.code[i].op);
+            EXPECT_EQ(actual.code[i].operand, expected.code[i].operand);
+        }
+        EXPECT_EQ(actual.constants, expected.constants);
+        EXPECT_EQ(actual.variables, expected.variables);
+        EXPECT_EQ(actual.positions, expected.positions);
+        EXPECT_EQ(actual.max_stack, expected.max_stack);
+    }
+
+    // 返回 "消息@位置"，没有出错时返回空串
+    template <typename Parse>
+    std::string error_of(Parse&& parse) {
+        try {
+            parse();
+        } catch (const CalculationError& e) {
+            return std::string(e.what()) + "@" + std::to_string(e.get_position());
+        }
+        return "";
+    }
+
+    // 所有前端都必须拒绝、且错误信息和位置与逆波兰路径一致的输入
+    inline constexpr const char* kMalformedExpressions[] = {
+        "", "1 +", "+ 1", "(1 + 2", "((1 + 2) * 3", "1 + 2)", ")", "()",
+        "1 2", "(1 2)", "(1 +) 2", "1 * (2 +", "1 (2)", "1 (2) 3", "1 (2",
+        "(1) (2)", "x y + 1", "1 2 $", "(1 + $", "1..2 + )", "1 + 2 ) $"};
+
+    // parse(expression) 对 kMalformedExpressions 中每个输入都应与 compile_rpn 报告相同的错误
+    template <typename Parse>
+    void expect_same_errors_as_rpn(Parse&& parse) {
+        for (const char* expression : kMalformedExpressions) {
+            std::string expected = error_of([&] { compile_rpn(expression); });
+            std::string actual = error_of([&] { parse(std::string(expression)); });
+            EXPECT_FALSE(expected.empty()) << expression;
+            EXPECT_EQ(actual, expected) << expression;
+        }
+    }
+
+} // namespace exprcalc::test
+
+#endif // EXPRCALC_TESTS_FRONT_END_SUPPORT_H
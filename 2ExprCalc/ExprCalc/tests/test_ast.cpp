@@ -0,0 +1,88 @@
+#include "../src/ast.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include "../src/expr_generator.h"
+#include "../src/lexer.h"
+#include "front_end_support.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+    using namespace exprcalc;
+    using namespace exprcalc::test;
+
+    TEST(AstTest, BuildsTree) {
+        Lexer lexer("2 * (x - 1) / y");
+        auto tokens = lexer.tokenize();
+        Ast ast;
+        AstParser(tokens).parse(ast);
+        EXPECT_EQ(ast.size(), 7u);
+        const AstNode& root = ast.node(ast.root());
+        ASSERT_EQ(root.kind, AstKind::BINARY);
+        EXPECT_EQ(root.op, Operator::DIV);
+        EXPECT_EQ(root.position, 12u);
+        EXPECT_EQ(ast.node(root.rhs).name, "y");
+        const AstNode& product = ast.node(root.lhs);
+        EXPECT_EQ(product.op, Operator::MUL);
+        EXPECT_DOUBLE_EQ(ast.node(product.lhs).number, 2.0);
+        EXPECT_EQ(ast.node(product.rhs).op, Operator::SUB);
+    }
+
+    TEST(AstTest, MatchesRpnCompilation) {
+        GeneratorOptions options;
+        options.seed = 5;
+        options.terms = 20;
+        options.paren_density = 0.4;
+        ExpressionGenerator generator(options);
+        Ast ast;
+        for (int i = 0; i < 200; ++i) {
+            std::string expression = generator.next();
+            SCOPED_TRACE(expression);
+            auto tokens = Lexer(expression).tokenize();
+            AstParser(tokens).parse(ast);
+            expect_same_bytecode(ast.to_bytecode(), compile_rpn(expression));
+        }
+    }
+
+    TEST(AstTest, SameErrorsAsShuntingYard) {
+        Ast ast;
+        expect_same_errors_as_rpn([&ast](const std::string& expression) {
+            auto tokens = Lexer(expression).tokenize();
+            AstParser(tokens).parse(ast);
+        });
+    }
+
+    TEST(AstTest, ArenaIsReused) {
+        Ast ast;
+        auto tokens = Lexer("a + b * c").tokenize();
+        AstParser(tokens).parse(ast);
+        Ast::NodeId root = ast.root();
+        AstParser(tokens).parse(ast);
+        EXPECT_EQ(ast.root(), root); // clear 后下标从头开始
+        EXPECT_EQ(ast.size(), 5u);
+    }
+
+    TEST(AstTest, DeepTreeDoesNotRecurse) {
+        std::string expression;
+        for (int i = 0; i < 50000; ++i) expression += "(1 + ";
+        expression += "x";
+        for (int i = 0; i < 50000; ++i) expression += ")";
+        auto tokens = Lexer(expression).tokenize();
+        Ast ast;
+        AstParser(tokens).parse(ast);
+        Bytecode bytecode = ast.to_bytecode();
+        EXPECT_EQ(bytecode.max_stack, 50001u);
+        double slots[] = {0.5};
+        EXPECT_DOUBLE_EQ(Evaluator::execute(bytecode, slots), 50000.5);
+    }
+
+    TEST(AstTest, CalculatorFrontEnd) {
+        Calculator calc;
+        calc.set_front_end(FrontEnd::AST);
+        calc.set_variable("x", 4.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("(x + 2) * x / 8 - 1"), 2.0);
+        EXPECT_THROW(calc.evaluate("(x + 2"), CalculationError);
+    }
+
+} // namespace
@@ -0,0 +1,195 @@
+#include "../src/batch_pipeline.h"
+#include "../src/batch_runner.h"
+#include "../src/mapped_file.h"
+#include "../src/spsc_queue.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+    using namespace exprcalc;
+
+    std::string read_all(std::FILE* out) {
+        std::string result;
+        std::rewind(out);
+        char buffer[256];
+        size_t read;
+        while ((read = std::fread(buffer, 1, sizeof(buffer), out)) > 0) result.append(buffer, read);
+        return result;
+    }
+
+    std::FILE* make_input(const std::string& input) {
+        std::FILE* in = std::tmpfile();
+        std::fwrite(input.data(), 1, input.size(), in);
+        std::rewind(in);
+        return in;
+    }
+
+    std::string run_batch(const std::string& input, size_t* errors = nullptr) {
+        std::FILE* in = make_input(input);
+        std::FILE* out = std::tmpfile();
+        Calculator calc;
+        BatchRunner runner(calc, out);
+        runner.run(in);
+        if (errors) *errors = runner.errors();
+        std::string result = read_all(out);
+        std::fclose(in);
+        std::fclose(out);
+        return result;
+    }
+
+    std::string run_pipeline(const std::string& input, PipelineOptions options, size_t* errors = nullptr) {
+        std::FILE* in = make_input(input);
+        std::FILE* out = std::tmpfile();
+        BatchPipeline pipeline(out, options);
+        pipeline.run(in);
+        if (errors) *errors = pipeline.errors();
+        std::string result = read_all(out);
+        std::fclose(in);
+        std::fclose(out);
+        return result;
+    }
+
+    TEST(BatchRunnerTest, OneResultPerLine) {
+        EXPECT_EQ(run_batch("2 + 3 * 4\n(1 + 2) / 4\n\n10 - 0.5\n"), "14\n0.75\n9.5\n");
+    }
+
+    TEST(BatchRunnerTest, SetCommandsProduceNoOutput) {
+        EXPECT_EQ(run_batch("set x = 2.5\nset  y=4 \r\nx * y\r\nx + 1"), "10\n3.5\n");
+    }
+
+    TEST(BatchRunnerTest, ErrorsAreReportedInline) {
+        size_t errors = 0;
+        std::string output = run_batch("1 / 0\nset x\nq + 1\n2 * 3\n", &errors);
+        EXPECT_EQ(output, "Error: Division by zero at position 2\n"
+                          "Error: Invalid set command\n"
+                          "Error: Undefined variable: q at position 0\n"
+                          "6\n");
+        EXPECT_EQ(errors, 3u);
+    }
+
+    TEST(BatchRunnerTest, LinesSpanningReadChunks) {
+        // 超过一个读缓冲区，保证有行跨越两次 fread
+        std::string input;
+        std::string expected;
+        for (size_t i = 0; input.size() < BatchRunner::kBufferSize * 2 + 100; ++i) {
+            input += std::to_string(i) + " + 1\n";
+            expected += std::to_string(i + 1) + "\n";
+        }
+        std::string output = run_batch(input);
+        ASSERT_EQ(output.size(), expected.size());
+        EXPECT_TRUE(output == expected);
+    }
+
+    TEST(BatchRunnerTest, NumberFormatting) {
+        std::string out;
+        for (double value : {200000.0, 0.1 + 0.2, -1.5, 1e300, 0.0}) {
+            BatchRunner::append_number(out, value);
+            out += ' ';
+        }
+        EXPECT_EQ(out, "200000 0.30000000000000004 -1.5 1e+300 0 ");
+    }
+
+    TEST(BatchRunnerTest, ParseSetCommand) {
+        std::string_view name;
+        double value = 0.0;
+        EXPECT_TRUE(BatchRunner::parse_set_command("set rate = 1e-3", name, value));
+        EXPECT_EQ(name, "rate");
+        EXPECT_DOUBLE_EQ(value, 1e-3);
+        EXPECT_FALSE(BatchRunner::parse_set_command("settle + 1", name, value));
+        EXPECT_THROW(BatchRunner::parse_set_command("set x = abc", name, value), std::runtime_error);
+    }
+
+    TEST(BatchPipelineTest, MatchesSerialOutput) {
+        // set 命令、错误行和普通表达式交错，且行块很小，覆盖跨块的变量快照
+        std::string input = "set x = 1\n";
+        for (int i = 0; i < 2000; ++i) {
+            input += std::to_string(i) + " * x + y\n";
+            if (i % 37 == 0) input += "set x = " + std::to_string(i % 5) + "\n";
+            if (i == 10) input += "set y = 0.5\n";
+            if (i % 101 == 0) input += std::to_string(i) + " / (x - x)\n";
+        }
+        size_t serial_errors = 0;
+        std::string expected = run_batch(input, &serial_errors);
+
+        for (size_t threads : {1, 2, 3, 8}) {
+            PipelineOptions options;
+            options.threads = threads;
+            options.block_lines = 7;
+            options.queue_depth = 2;
+            size_t errors = 0;
+            std::string output = run_pipeline(input, options, &errors);
+            ASSERT_EQ(output.size(), expected.size()) << threads << " threads";
+            EXPECT_TRUE(output == expected) << threads << " threads";
+            EXPECT_EQ(errors, serial_errors);
+        }
+    }
+
+    TEST(BatchPipelineTest, BorrowedInputMatchesStream) {
+        std::string input = "set a = 2\n\n  a * 3\r\n1 / 0\nset a = 5\na + 1";
+        for (int i = 0; i < 500; ++i) input += "\na * " + std::to_string(i);
+        std::string expected = run_batch(input);
+
+        PipelineOptions options;
+        options.threads = 3;
+        options.block_lines = 5;
+        std::FILE* out = std::tmpfile();
+        BatchPipeline pipeline(out, options);
+        pipeline.run(std::string_view(input));
+        EXPECT_EQ(read_all(out), expected);
+        EXPECT_EQ(pipeline.lines_processed(), 505u);
+        std::fclose(out);
+
+        out = std::tmpfile();
+        Calculator calc;
+        BatchRunner runner(calc, out);
+        runner.run(std::string_view(input));
+        EXPECT_EQ(read_all(out), expected);
+        std::fclose(out);
+    }
+
+    TEST(MappedFileTest, MapsWholeFile) {
+        std::string path = ::testing::TempDir() + "exprcalc_mapped_file.txt";
+        std::string content = "1 + 2\nset x = 3\nx * x\n";
+        std::ofstream(path, std::ios::binary) << content;
+        {
+            MappedFile file(path);
+            EXPECT_EQ(file.size(), content.size());
+            EXPECT_EQ(file.view(), content);
+        }
+        std::ofstream(path, std::ios::binary | std::ios::trunc);
+        {
+            MappedFile empty(path);
+            EXPECT_EQ(empty.size(), 0u);
+            EXPECT_TRUE(empty.view().empty());
+        }
+        std::remove(path.c_str());
+        EXPECT_THROW(MappedFile{path}, std::runtime_error);
+    }
+
+    TEST(BatchPipelineTest, EmptyInput) {
+        PipelineOptions options;
+        options.threads = 4;
+        EXPECT_EQ(run_pipeline("", options), "");
+        EXPECT_EQ(run_pipeline("\n\n", options), "");
+    }
+
+    TEST(SpscQueueTest, PreservesOrderAcrossThreads) {
+        SpscQueue<int> queue(4);
+        std::thread producer([&] {
+            for (int i = 1; i <= 100000; ++i) queue.push(i);
+            queue.push(0);
+        });
+        int expected = 1;
+        while (int value = queue.pop()) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+        producer.join();
+        EXPECT_EQ(expected, 100001);
+    }
+
+} // namespace
\ No newline at end of file
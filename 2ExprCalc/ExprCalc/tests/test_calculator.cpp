@@ -1,6 +1,7 @@
 #include "../src/calculator.h"
 #include "../src/error.h"
 #include <gtest/gtest.h>
+#include <memory>
 
 namespace {
 
@@ -13,6 +14,13 @@ namespace {
         EXPECT_DOUBLE_EQ(calc.evaluate("(2 + 3) * 4"), 20.0);
     }
 
+    TEST(CalculatorTest, LeftAssociativity) {
+        Calculator calc;
+        EXPECT_DOUBLE_EQ(calc.evaluate("8 - 3 - 2"), 3.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("16 / 4 / 2"), 2.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("2 * 6 / 3 - 1 + 4"), 7.0);
+    }
+
     TEST(CalculatorTest, VariableEvaluation) {
         Calculator calc;
         calc.set_variable("x", 5.0);
@@ -28,9 +36,28 @@ namespace {
             calc.evaluate("5 / 0");
         } catch (const CalculationError& e) {
             EXPECT_STREQ(e.what(), "Division by zero");
+            EXPECT_EQ(e.get_position(), 2);
         }
     }
 
+    TEST(CalculatorTest, BytecodeLowering) {
+        Calculator calc;
+        auto compiled = calc.compile("x * 2.5 + x");
+        const auto& bytecode = compiled.bytecode();
+        ASSERT_EQ(bytecode.code.size(), 5);
+        EXPECT_EQ(bytecode.code[0].op, OpCode::LOAD_VAR);
+        EXPECT_EQ(bytecode.code[1].op, OpCode::PUSH_CONST);
+        EXPECT_EQ(bytecode.code[2].op, OpCode::MUL);
+        EXPECT_EQ(bytecode.code[3].op, OpCode::LOAD_VAR);
+        EXPECT_EQ(bytecode.code[4].op, OpCode::ADD);
+        ASSERT_EQ(bytecode.variables.size(), 1);
+        EXPECT_EQ(bytecode.code[3].operand, 0);
+        ASSERT_EQ(bytecode.constants.size(), 1);
+        EXPECT_DOUBLE_EQ(bytecode.constants[0], 2.5);
+        EXPECT_EQ(bytecode.max_stack, 2);
+        EXPECT_DOUBLE_EQ(compiled.evaluate({{"x", 2.0}}), 7.0);
+    }
+
     TEST(CalculatorTest, UndefinedVariable) {
         Calculator calc;
         EXPECT_THROW(calc.evaluate("x + 1"), CalculationError);
@@ -51,4 +78,164 @@ namespace {
         }
     }
 
+    TEST(CalculatorTest, CompileOnceEvaluateMany) {
+        Calculator calc;
+        auto compiled = calc.compile("x * y + 3");
+        calc.set_variable("x", 5.0);
+        calc.set_variable("y", 2.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate(compiled), 13.0);
+        calc.set_variable("x", 1.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate(compiled), 5.0);
+
+        SymbolTable symbols;
+        symbols.set_variable("x", 4.0);
+        symbols.set_variable("y", 0.5);
+        EXPECT_DOUBLE_EQ(compiled.evaluate(symbols), 5.0);
+        EXPECT_DOUBLE_EQ(compiled.evaluate({{"x", 10.0}, {"y", 3.0}}), 33.0);
+        EXPECT_THROW(compiled.evaluate({{"x", 1.0}}), CalculationError);
+    }
+
+    TEST(CalculatorTest, BatchEvaluation) {
+        Calculator calc;
+        calc.set_variable("k", 10.0);
+        const size_t rows = 1000; // 跨越多个块，最后一块不满
+        std::vector<double> x(rows), y(rows), out(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            x[i] = static_cast<double>(i);
+            y[i] = static_cast<double>(i % 7) + 1.0;
+        }
+        calc.evaluate_batch("(x + 2) * y - x / y + k", {{"x", x}, {"y", y}}, out);
+        for (size_t i = 0; i < rows; ++i) {
+            EXPECT_DOUBLE_EQ(out[i], (x[i] + 2) * y[i] - x[i] / y[i] + 10.0) << "row " << i;
+        }
+    }
+
+    TEST(CalculatorTest, BatchDivisionByZeroReportsRow) {
+        Calculator calc;
+        std::vector<double> x(600, 1.0), out(600);
+        x[517] = 0.0;
+        try {
+            calc.evaluate_batch("1 / x", {{"x", x}}, out);
+            FAIL() << "expected BatchError";
+        } catch (const BatchError& e) {
+            EXPECT_STREQ(e.what(), "Division by zero");
+            EXPECT_EQ(e.get_row(), 517);
+            EXPECT_EQ(e.get_position(), 2);
+        }
+        EXPECT_THROW(calc.evaluate_batch("x + z", {{"x", x}}, out), CalculationError);
+    }
+
+    TEST(CalculatorTest, ParallelBatchMatchesSerial) {
+        const size_t rows = 100000;
+        std::vector<double> x(rows), serial(rows), parallel(rows);
+        for (size_t i = 0; i < rows; ++i) x[i] = static_cast<double>(i) + 1.0;
+
+        Calculator calc;
+        auto compiled = calc.compile("x * x / (x + 1) - 3");
+        compiled.evaluate_batch({{"x", x}}, serial);
+
+        ThreadPool pool(4);
+        BatchEvaluator evaluator(compiled.bytecode(), {{"x", x}});
+        evaluator.evaluate_parallel(parallel, pool, 1024);
+        EXPECT_EQ(serial, parallel);
+
+        calc.set_batch_threads(3);
+        std::fill(parallel.begin(), parallel.end(), 0.0);
+        calc.evaluate_batch(compiled, {{"x", x}}, parallel);
+        EXPECT_EQ(serial, parallel);
+    }
+
+    TEST(CalculatorTest, ParallelBatchReportsFirstErrorRow) {
+        const size_t rows = 50000;
+        std::vector<double> x(rows, 2.0), out(rows);
+        x[41234] = 0.0;
+        x[7777] = 0.0;
+        ThreadPool pool(4);
+        Calculator calc;
+        auto compiled = calc.compile("1 / x");
+        BatchEvaluator evaluator(compiled.bytecode(), {{"x", x}});
+        try {
+            evaluator.evaluate_parallel(out, pool, 512);
+            FAIL() << "expected BatchError";
+        } catch (const BatchError& e) {
+            EXPECT_EQ(e.get_row(), 7777);
+        }
+        // 其他块不受影响，仍然算完
+        EXPECT_DOUBLE_EQ(out[rows - 1], 0.5);
+    }
+
+    TEST(CalculatorTest, ExpressionCache) {
+        Calculator calc;
+        calc.set_cache_capacity(2);
+        calc.set_variable("x", 2.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("x + 1"), 3.0);
+        calc.set_variable("x", 5.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("x + 1"), 6.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("x * 2"), 10.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("x - 1"), 4.0); // 淘汰 "x + 1"
+        EXPECT_DOUBLE_EQ(calc.evaluate("x + 1"), 6.0);
+        CacheStats stats = calc.cache_stats();
+        EXPECT_EQ(stats.hits, 1);
+        EXPECT_EQ(stats.misses, 4);
+        EXPECT_EQ(stats.evictions, 2);
+        EXPECT_EQ(stats.size, 2);
+        EXPECT_EQ(stats.capacity, 2);
+
+        // 编译失败的表达式不进入缓存
+        EXPECT_THROW(calc.evaluate("x +"), CalculationError);
+        EXPECT_EQ(calc.cache_stats().size, 2);
+    }
+
+    TEST(CalculatorTest, CopyOfWarmedCalculatorOwnsItsCache) {
+        auto original = std::make_unique<Calculator>();
+        original->set_variable("x", 2.0);
+        EXPECT_DOUBLE_EQ(original->evaluate("1+2"), 3.0);
+        EXPECT_DOUBLE_EQ(original->evaluate("x * 3"), 6.0);
+
+        Calculator copy(*original);
+        original.reset();
+        EXPECT_DOUBLE_EQ(copy.evaluate("1+2"), 3.0);
+        EXPECT_DOUBLE_EQ(copy.evaluate("x * 3"), 6.0);
+        EXPECT_DOUBLE_EQ(copy.evaluate("x - 1"), 1.0);
+        EXPECT_EQ(copy.cache_stats().hits, 2);
+        EXPECT_EQ(copy.cache_stats().size, 3);
+    }
+
+    TEST(CalculatorTest, ExpressionCacheWhitespaceNormalization) {
+        std::string key;
+        ExpressionCache::normalize("  ( a  +\tb1 ) *  2 ", key);
+        EXPECT_EQ(key, "(a+b1)*2");
+        ExpressionCache::normalize("x y", key);
+        EXPECT_EQ(key, "x y");
+
+        Calculator calc;
+        calc.set_cache_normalize_whitespace(true);
+        calc.evaluate("1 + 2");
+        calc.evaluate("1+2");
+        calc.evaluate(" 1 +  2 ");
+        EXPECT_EQ(calc.cache_stats().hits, 2);
+        EXPECT_EQ(calc.cache_stats().size, 1);
+    }
+
+    TEST(CalculatorTest, WhitespaceNormalizationKeepsLiteralsApart) {
+        std::string key;
+        ExpressionCache::normalize("2e -3", key);
+        EXPECT_EQ(key, "2e -3");
+        ExpressionCache::normalize("2e- 3", key);
+        EXPECT_EQ(key, "2e- 3");
+        ExpressionCache::normalize("1 _0", key);
+        EXPECT_EQ(key, "1 _0");
+        ExpressionCache::normalize("x - 3 + 0x1p -2", key);
+        EXPECT_EQ(key, "x-3+0x1p -2");
+
+        // 缓存了合法写法后，只差空白的非法写法仍然要报错
+        Calculator calc;
+        calc.set_cache_normalize_whitespace(true);
+        EXPECT_DOUBLE_EQ(calc.evaluate("2e-3"), 0.002);
+        EXPECT_THROW(calc.evaluate("2e -3"), CalculationError);
+        EXPECT_THROW(calc.evaluate("2e- 3"), CalculationError);
+        EXPECT_DOUBLE_EQ(calc.evaluate("1_0"), 10.0);
+        EXPECT_THROW(calc.evaluate("1 _0"), CalculationError);
+    }
+
 } // anonymous namespace
\ No newline at end of file
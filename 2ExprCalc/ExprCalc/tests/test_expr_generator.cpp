@@ -0,0 +1,48 @@
+#include "../src/expr_generator.h"
+#include "../src/calculator.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace {
+
+    using namespace exprcalc;
+
+    TEST(ExprGeneratorTest, SameSeedSameSequence) {
+        GeneratorOptions options;
+        options.seed = 42;
+        ExpressionGenerator a(options), b(options);
+        for (int i = 0; i < 50; ++i) EXPECT_EQ(a.next(), b.next());
+
+        options.seed = 43;
+        ExpressionGenerator c(options);
+        EXPECT_NE(ExpressionGenerator(GeneratorOptions{}).next(), c.next());
+    }
+
+    TEST(ExprGeneratorTest, ExpressionsEvaluateWithBindings) {
+        GeneratorOptions options;
+        options.seed = 7;
+        options.terms = 40;
+        options.max_depth = 6;
+        options.paren_density = 0.5;
+        options.operator_weights = {1, 1, 1, 3};
+        options.variables = 6;
+        ExpressionGenerator generator(options);
+
+        std::stringstream bindings;
+        generator.write_bindings(bindings);
+        Calculator calc;
+        std::string line;
+        size_t count = 0;
+        while (std::getline(bindings, line)) {
+            auto eq = line.find('=');
+            calc.set_variable(line.substr(4, eq - 5), std::stod(line.substr(eq + 1)));
+            ++count;
+        }
+        EXPECT_EQ(count, 6);
+        for (int i = 0; i < 200; ++i) {
+            std::string expression = generator.next();
+            EXPECT_NO_THROW(calc.evaluate(expression)) << expression;
+        }
+    }
+
+} // anonymous namespace
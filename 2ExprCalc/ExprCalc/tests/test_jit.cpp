@@ -0,0 +1,57 @@
+#include "../src/jit.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+
+namespace {
+
+    using namespace exprcalc;
+
+    TEST(JitTest, MatchesInterpreter) {
+        if (!JitFunction::available()) GTEST_SKIP() << "JIT not supported on this platform";
+        Calculator calc;
+        auto compiled = calc.compile("(a + 2.5) * b - a / (b - 1) + 3 * (a - b * (a + 1))");
+        auto jit = JitFunction::compile(compiled.bytecode());
+        ASSERT_NE(jit, nullptr);
+        for (double a : {-3.0, 0.0, 1.5, 1e10}) {
+            for (double b : {-2.0, 0.5, 7.0}) {
+                double slots[] = {a, b};
+                EXPECT_DOUBLE_EQ(jit->evaluate(slots), Evaluator::execute(compiled.bytecode(), slots));
+            }
+        }
+    }
+
+    TEST(JitTest, DivisionByZero) {
+        if (!JitFunction::available()) GTEST_SKIP() << "JIT not supported on this platform";
+        Calculator calc;
+        calc.set_jit_enabled(true);
+        auto compiled = calc.compile("x / (y - 2) / y");
+        ASSERT_TRUE(compiled.jit_enabled());
+        EXPECT_DOUBLE_EQ(compiled.evaluate({{"x", 6.0}, {"y", 4.0}}), 0.75);
+        try {
+            compiled.evaluate({{"x", 1.0}, {"y", 2.0}});
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_STREQ(e.what(), "Division by zero");
+            EXPECT_EQ(e.get_position(), 2);
+        }
+        // NaN 不等于 0，不应触发除零错误
+        EXPECT_TRUE(std::isnan(compiled.evaluate({{"x", 1.0}, {"y", std::nan("")}})));
+    }
+
+    TEST(JitTest, FallsBackWhenStackTooDeep) {
+        // 右嵌套的括号让栈深度随长度增长，超出可用的 XMM 寄存器数；用变量避免被常量折叠
+        std::string expression = "x";
+        for (int i = 0; i < 40; ++i) expression = "x + (" + expression + ")";
+        Calculator calc;
+        calc.set_variable("x", 1.0);
+        calc.set_jit_enabled(true);
+        auto compiled = calc.compile(expression);
+        EXPECT_EQ(JitFunction::compile(compiled.bytecode()), nullptr);
+        EXPECT_FALSE(compiled.jit_enabled());
+        EXPECT_DOUBLE_EQ(calc.evaluate(compiled), 41.0);
+    }
+
+} // anonymous namespace
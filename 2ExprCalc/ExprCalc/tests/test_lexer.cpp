@@ -1,6 +1,13 @@
 #include "../src/lexer.h"
+#include "../src/char_class.h"
 #include "../src/error.h"
 #include <gtest/gtest.h>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <random>
+#include <string>
 
 namespace {
 
@@ -27,6 +34,17 @@ namespace {
         EXPECT_EQ(tokens[4].position, 8);
     }
 
+    TEST(LexerTest, OperatorTable) {
+        static_assert(find_operator('*')->precedence > find_operator('-')->precedence);
+        static_assert(find_operator('x') == nullptr);
+        Lexer lexer("a - b / c");
+        auto tokens = lexer.tokenize();
+        ASSERT_EQ(tokens.size(), 5);
+        EXPECT_EQ(tokens[1].op, Operator::SUB);
+        EXPECT_EQ(tokens[3].op, Operator::DIV);
+        EXPECT_EQ(operator_info(tokens[3].op).opcode, OpCode::DIV);
+    }
+
     TEST(LexerTest, Parentheses) {
         Lexer lexer("(2 + 3)");
         auto tokens = lexer.tokenize();
@@ -59,4 +77,136 @@ namespace {
         }
     }
 
+    TEST(LexerTest, TokensBorrowInput) {
+        std::string input = "alpha * 12.5";
+        Lexer lexer(input);
+        auto tokens = lexer.tokenize();
+        ASSERT_EQ(tokens.size(), 3);
+        EXPECT_EQ(tokens[0].value, "alpha");
+        EXPECT_EQ(tokens[0].value.data(), input.data());
+        EXPECT_EQ(tokens[2].type, TokenType::NUMBER);
+        EXPECT_EQ(tokens[2].value.data(), input.data() + 8);
+        EXPECT_DOUBLE_EQ(tokens[2].number, 12.5);
+    }
+
+    TEST(LexerTest, MalformedNumber) {
+        Lexer lexer("1 + 1.2.3");
+        try {
+            lexer.tokenize();
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_EQ(e.get_position(), 4);
+            EXPECT_STREQ(e.what(), "Invalid number: 1.2.3");
+        }
+    }
+
+    double lex_number(const std::string& text) {
+        auto tokens = Lexer(text).tokenize();
+        EXPECT_EQ(tokens.size(), 1u) << text;
+        EXPECT_EQ(tokens[0].type, TokenType::NUMBER) << text;
+        return tokens[0].number;
+    }
+
+    TEST(LexerTest, NumberFormats) {
+        EXPECT_EQ(lex_number("1e-9"), 1e-9);
+        EXPECT_EQ(lex_number("6.02E23"), 6.02e23);
+        EXPECT_EQ(lex_number("2.5e+3"), 2500.0);
+        EXPECT_EQ(lex_number(".5"), 0.5);
+        EXPECT_EQ(lex_number("5."), 5.0);
+        EXPECT_EQ(lex_number("0x1.8p3"), 12.0);
+        EXPECT_EQ(lex_number("0XFF"), 255.0);
+        EXPECT_EQ(lex_number("0x.8P-1"), 0.25);
+        EXPECT_EQ(lex_number("1_000_000"), 1e6);
+        EXPECT_EQ(lex_number("3.141_592e1_0"), 3.141592e10);
+        // 正确舍入：恰好在两个 double 中间的值按偶数舍入
+        EXPECT_EQ(lex_number("9007199254740993"), 9007199254740992.0);
+    }
+
+    TEST(LexerTest, ExponentNeedsDigits) {
+        auto tokens = Lexer("2e + 3ex").tokenize();
+        ASSERT_EQ(tokens.size(), 5u);
+        EXPECT_EQ(tokens[0].value, "2");
+        EXPECT_EQ(tokens[1].value, "e");
+        EXPECT_EQ(tokens[3].value, "3");
+        EXPECT_EQ(tokens[4].value, "ex");
+    }
+
+    TEST(LexerTest, MalformedNumberFormats) {
+        for (const char* text : {"1.2.3", "1__0", "1_", "1_.5", "1._5", "1e5_", "0x", "0x_", "0x1.2.3p1", "."}) {
+            try {
+                Lexer(std::string("x + ") + text).tokenize();
+                ADD_FAILURE() << text;
+            } catch (const CalculationError& e) {
+                EXPECT_EQ(e.get_position(), 4u) << text;
+                EXPECT_EQ(std::string(e.what()), std::string("Invalid number: ") + text);
+            }
+        }
+        EXPECT_THROW(Lexer("1e400").tokenize(), CalculationError);
+    }
+
+    TEST(LexerTest, ShortestFormRoundTrips) {
+        std::mt19937_64 rng(7);
+        char buffer[64];
+        for (int i = 0; i < 10000; ++i) {
+            double value = std::abs(std::bit_cast<double>(rng()));
+            if (!std::isfinite(value) || value < 1e-300) continue;
+            auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+            ASSERT_EQ(lex_number(std::string(buffer, end)), value) << std::string(buffer, end);
+            end = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::hex).ptr;
+            ASSERT_EQ(lex_number("0x" + std::string(buffer, end)), value) << std::string(buffer, end);
+        }
+    }
+
+    TEST(LexerTest, SimdScanMatchesScalar) {
+        // 长空白、长标识符和长数字跨越 64 字节块边界
+        std::mt19937_64 rng(3);
+        const std::string pieces[] = {" ", "\t", "\n  ", std::string(70, ' '), "+", "*", "(", ")", "x1",
+                                      "alpha" + std::string(80, 'b'), " 12.5 ", " 1_000\t", " " + std::string(90, '7') + " ",
+                                      " 6.02e23 ", " 0x1.8p3 ", "z"};
+        std::string input;
+        for (int i = 0; i < 5000; ++i) input += pieces[rng() % std::size(pieces)];
+
+        const auto expected = Lexer(input, SimdLevel::SCALAR).tokenize();
+        for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            const auto tokens = Lexer(input, level).tokenize();
+            ASSERT_EQ(tokens.size(), expected.size());
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                ASSERT_EQ(tokens[i].type, expected[i].type);
+                ASSERT_EQ(tokens[i].position, expected[i].position);
+                ASSERT_EQ(tokens[i].value, expected[i].value);
+            }
+        }
+        // 以空白或标识符结尾、恰好落在块边界上的输入
+        for (size_t length : {63, 64, 65, 128}) {
+            EXPECT_EQ(Lexer(std::string(length, ' ')).tokenize().size(), 0u);
+            auto tokens = Lexer(std::string(length, 'v')).tokenize();
+            ASSERT_EQ(tokens.size(), 1u);
+            EXPECT_EQ(tokens[0].value.size(), length);
+        }
+    }
+
+    TEST(LexerTest, CharTableMatchesCLocale) {
+        static_assert(is_space('\v') && !is_space('a') && is_hex_digit('F') && !is_hex_digit('g'));
+        static_assert(char_info('(').start == TokenStart::LEFT_PAREN && char_info('/').start == TokenStart::OPERATOR);
+        for (int c = 0; c < 128; ++c) {
+            const char ch = static_cast<char>(c);
+            EXPECT_EQ(is_space(ch), std::isspace(c) != 0) << c;
+            EXPECT_EQ(is_digit(ch), std::isdigit(c) != 0) << c;
+            EXPECT_EQ(is_alpha(ch), std::isalpha(c) != 0) << c;
+            EXPECT_EQ(is_alnum(ch), std::isalnum(c) != 0) << c;
+            EXPECT_EQ(is_hex_digit(ch), std::isxdigit(c) != 0) << c;
+        }
+        // 非 ASCII 字节在任何 locale 下都不是字母或空白
+        for (int c = 128; c < 256; ++c) {
+            EXPECT_EQ(char_info(static_cast<char>(c)).classes, 0) << c;
+            EXPECT_EQ(char_info(static_cast<char>(c)).start, TokenStart::INVALID) << c;
+        }
+        try {
+            Lexer("x + \xE9").tokenize();
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_EQ(e.get_position(), 4u);
+        }
+    }
+
 } // anonymous namespace
\ No newline at end of file
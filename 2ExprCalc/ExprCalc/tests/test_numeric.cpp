@@ -0,0 +1,276 @@
+#include "../src/numeric.h"
+#include "../src/decimal.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include "../src/interpreter.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace exprcalc;
+
+    void expect_integer(const IntegerValue& value, std::int64_t expected) {
+        EXPECT_TRUE(value.is_integer);
+        EXPECT_EQ(value.integer, expected);
+    }
+
+    void expect_real(const IntegerValue& value, double expected) {
+        EXPECT_FALSE(value.is_integer);
+        EXPECT_DOUBLE_EQ(value.real, expected);
+    }
+
+    TEST(IntegerModeTest, ExactBeyondDoublePrecision) {
+        Calculator calc;
+        calc.set_variable("x", 0x1p53);
+        EXPECT_EQ(calc.evaluate("x + 1"), 0x1p53); // double 中 +1 被舍入掉
+        expect_integer(calc.evaluate_integer("x + 1"), 9007199254740993);
+        expect_integer(calc.evaluate_integer("x + 1 + 1 - x"), 2);
+        // 常量部分不能在编译期按 double 折叠
+        expect_integer(calc.evaluate_integer("9007199254740992 + 1 + 1"), 9007199254740994);
+        expect_integer(calc.evaluate_integer("3037000499 * 3037000499"), 9223372030926249001);
+        // 2^53 以上的字面量按源文本读取，不用 double 舍入后的值
+        expect_integer(calc.evaluate_integer("9007199254740993 + 0"), 9007199254740993);
+        expect_integer(calc.evaluate_integer("9_007_199_254_740_993 - x"), 1);
+        // 读不出精确整数的大常量不冒充整数
+        expect_real(calc.evaluate_integer("1e17 + 0"), 1e17);
+        expect_real(calc.evaluate_integer("99999999999999999999 - 1"), 1e20);
+    }
+
+    TEST(IntegerModeTest, PromotesToDouble) {
+        Calculator calc;
+        calc.set_variable("big", 0x1p62);
+        expect_real(calc.evaluate_integer("big * 4"), 0x1p64);
+        expect_real(calc.evaluate_integer("3037000500 * 3037000500"), 3037000500.0 * 3037000500.0);
+        expect_real(calc.evaluate_integer("big + big"), 0x1p63);
+        expect_real(calc.evaluate_integer("7 / 2"), 3.5);
+        expect_real(calc.evaluate_integer("0.5 + 1"), 1.5);
+        expect_integer(calc.evaluate_integer("6 / 3"), 2);
+        calc.set_variable("seven", 7);
+        expect_real(calc.evaluate_integer("(seven / 2) * 2"), 7.0); // 退化为 double 后不再变回整数
+        // 结果类型不取决于常量折叠是否发生
+        expect_real(calc.evaluate_integer("(7 / 2) * 2"), 7.0);
+        expect_real(calc.evaluate_integer("1.5 * 2 + seven"), 10.0);
+        expect_real(calc.evaluate_integer("1e300 / 1e290"), 1e10);
+        expect_integer(calc.evaluate_integer("(8 / 2) * 2 + seven"), 15);
+    }
+
+    TEST(IntegerModeTest, ConstantsConvertedOnce) {
+        Calculator calc;
+        calc.set_variable("x", 4);
+        const auto compiled = calc.compile("x * 3 + 0.5 - x / 8");
+        SymbolTable symbols;
+        symbols.set_variable("x", 4);
+        expect_real(compiled.evaluate_as<IntegerArithmetic>(symbols), 12.0);
+        symbols.set_variable("x", 16);
+        expect_real(compiled.evaluate_as<IntegerArithmetic>(symbols), 46.5);
+        EXPECT_EQ(compiled.evaluate_as<DoubleArithmetic>(symbols), compiled.evaluate(symbols));
+    }
+
+    TEST(IntegerModeTest, Int64FastPathMatchesTaggedPath) {
+        Calculator calc;
+        const auto compiled = calc.compile("a * b - a / 3 + c");
+        const Bytecode& bytecode = compiled.bytecode();
+        std::vector<IntegerValue> constants;
+        for (double constant : bytecode.constants) constants.push_back(IntegerArithmetic::from_double(constant));
+        const double big = 0x1p62;
+        const double cases[][3] = {{9, 4, 1}, {10, 4, 1}, {big, 4, 0}, {big, 1, big}, {6, 2, 0.5}, {-9, -9, -big}};
+        for (const auto& values : cases) {
+            SymbolTable symbols;
+            symbols.set_variable("a", values[0]);
+            symbols.set_variable("b", values[1]);
+            symbols.set_variable("c", values[2]);
+            const double slots[] = {values[0], values[1], values[2]};
+            const IntegerValue tagged = interpret_converted<IntegerArithmetic>(bytecode, constants.data(), slots);
+            const IntegerValue fast = compiled.evaluate_as<IntegerArithmetic>(symbols);
+            EXPECT_EQ(fast.is_integer, tagged.is_integer);
+            EXPECT_EQ(fast.to_double(), tagged.to_double());
+        }
+        EXPECT_THROW(Int64Arithmetic::add(std::numeric_limits<std::int64_t>::max(), 1), IntegerPromotion);
+        EXPECT_THROW(Int64Arithmetic::div(7, 2), IntegerPromotion);
+        EXPECT_EQ(Int64Arithmetic::div(-8, 2), -4);
+    }
+
+    TEST(IntegerModeTest, OverflowHelpers) {
+        constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+        constexpr std::int64_t min = std::numeric_limits<std::int64_t>::min();
+        const IntegerValue top = IntegerValue::of(max);
+        const IntegerValue bottom = IntegerValue::of(min);
+        const IntegerValue one = IntegerValue::of(1);
+        const IntegerValue minus_one = IntegerValue::of(-1);
+        EXPECT_FALSE(IntegerArithmetic::add(top, one).is_integer);
+        EXPECT_FALSE(IntegerArithmetic::sub(bottom, one).is_integer);
+        EXPECT_FALSE(IntegerArithmetic::mul(bottom, minus_one).is_integer);
+        EXPECT_FALSE(IntegerArithmetic::div(bottom, minus_one).is_integer);
+        EXPECT_FALSE(IntegerArithmetic::neg(bottom).is_integer);
+        expect_integer(IntegerArithmetic::add(top, minus_one), max - 1);
+        expect_integer(IntegerArithmetic::neg(top), -max);
+        expect_integer(IntegerArithmetic::from_double(-0x1p63), min);
+        EXPECT_FALSE(IntegerArithmetic::from_double(0x1p63).is_integer);
+    }
+
+    TEST(IntegerModeTest, SameErrorsAsDouble) {
+        Calculator calc;
+        calc.set_variable("y", 3);
+        try {
+            calc.evaluate_integer("1 + 4 / (y - y)");
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_STREQ(e.what(), "Division by zero");
+            EXPECT_EQ(e.get_position(), 6u);
+        }
+        EXPECT_THROW(calc.evaluate_integer("z + 1"), CalculationError);
+        calc.set_front_end(FrontEnd::PRATT);
+        expect_integer(calc.evaluate_integer("-y * 2"), -6);
+    }
+
+    TEST(IntegerModeTest, DoubleInterpreterUnchanged) {
+        Calculator calc;
+        calc.set_variable("a", 1.5);
+        calc.set_variable("b", -2.25);
+        const auto compiled = calc.compile("a * b - a / b + (a - b) * (a - b)");
+        const double slots[] = {1.5, -2.25};
+        EXPECT_EQ(interpret<DoubleArithmetic>(compiled.bytecode(), compiled.bytecode().constants.data(), slots),
+                  calc.evaluate(compiled));
+        SymbolTable symbols;
+        symbols.set_variable("a", 1.5);
+        symbols.set_variable("b", -2.25);
+        EXPECT_EQ(compiled.evaluate_as<DoubleArithmetic>(symbols), compiled.evaluate(symbols));
+    }
+
+#if defined(EXPRCALC_HAS_INT128)
+
+    std::string decimal(Calculator& calc, std::string_view expression) {
+        return calc.evaluate_decimal(expression).to_string();
+    }
+
+    TEST(DecimalModeTest, ExactMoneyArithmetic) {
+        Calculator calc;
+        EXPECT_NE(calc.evaluate("0.1 + 0.2"), 0.3);
+        EXPECT_EQ(decimal(calc, "0.1 + 0.2"), "0.3000");
+        calc.set_variable("price", 19.99);
+        calc.set_variable("qty", 3);
+        EXPECT_EQ(decimal(calc, "price * qty - 0.97"), "59.0000");
+        EXPECT_EQ(decimal(calc, "1 / 3"), "0.3333");
+        EXPECT_EQ(decimal(calc, "2 / 3"), "0.6667");
+        EXPECT_EQ(decimal(calc, "0 - 2 / 3"), "-0.6667");
+        EXPECT_EQ(decimal(calc, "0.00005"), "0.0000"); // 恰好一半，取偶
+        EXPECT_EQ(decimal(calc, "0.00015"), "0.0002");
+        EXPECT_EQ(calc.evaluate_decimal("price * qty").to_double(), 59.97);
+    }
+
+    TEST(DecimalModeTest, LiteralsBypassDouble) {
+        Calculator calc;
+        EXPECT_EQ(decimal(calc, "12345678901234.5678 + 0"), "12345678901234.5678");
+        EXPECT_EQ(decimal(calc, "9999999999999999.99 - 0.01"), "9999999999999999.9800");
+        EXPECT_EQ(decimal(calc, "1_000_000.0001 * 1"), "1000000.0001");
+        calc.set_front_end(FrontEnd::PRATT);
+        EXPECT_EQ(decimal(calc, "-12345678901234.5678 + 0x10"), "-12345678901218.5678");
+        calc.set_front_end(FrontEnd::STREAMING);
+        // 只在 double 精度之外不同的两个字面量不能被当成同一个公共子表达式
+        calc.set_variable("x", 2);
+        calc.set_decimal_options({18, RoundingMode::HALF_EVEN});
+        EXPECT_EQ(decimal(calc, "x * 0.100000000000000001 - x * 0.1"), "0.000000000000000002");
+        // 在 double 中舍入成 1 的字面量不能被当作单位元化简掉
+        EXPECT_EQ(decimal(calc, "x * 1.000000000000000001"), "2.000000000000000002");
+        EXPECT_EQ(decimal(calc, "1.000000000000000001 * x"), "2.000000000000000002");
+        EXPECT_EQ(decimal(calc, "x / 1.000000000000000001"), "1.999999999999999998");
+        EXPECT_EQ(decimal(calc, "x + 1.000000000000000001"), "3.000000000000000001");
+
+        // 常量池只在编译时转换一次；之后改变小数位数时按字面量重新转换
+        calc.set_decimal_options({4, RoundingMode::HALF_EVEN});
+        const auto compiled = calc.compile_exact("12345678901234.5678 * 2");
+        EXPECT_EQ(calc.evaluate_decimal(compiled).to_string(), "24691357802469.1356");
+        calc.set_decimal_options({2, RoundingMode::DOWN});
+        EXPECT_EQ(calc.evaluate_decimal(compiled).to_string(), "24691357802469.12");
+    }
+
+    TEST(DecimalModeTest, CompiledExpressionsCached) {
+        Calculator calc;
+        calc.set_decimal_options({4, RoundingMode::HALF_EVEN});
+        EXPECT_EQ(decimal(calc, "0.12345 * 3"), "0.3702");
+        EXPECT_EQ(decimal(calc, "0.12345 * 3"), "0.3702");
+        CacheStats stats = calc.decimal_cache_stats();
+        EXPECT_EQ(stats.misses, 1u);
+        EXPECT_EQ(stats.hits, 1u);
+        EXPECT_EQ(calc.cache_stats().size, 0u); // 与 evaluate 的缓存分开，常量池不会混用
+
+        // 常量池按十进制选项转换，改变选项后重新编译
+        calc.set_decimal_options({2, RoundingMode::DOWN});
+        EXPECT_EQ(calc.decimal_cache_stats().size, 0u);
+        EXPECT_EQ(decimal(calc, "0.12345 * 3"), "0.36");
+        EXPECT_EQ(calc.decimal_cache_stats().misses, 2u);
+
+        calc.set_cache_capacity(0);
+        EXPECT_EQ(decimal(calc, "0.12345 * 3"), "0.36");
+        EXPECT_EQ(calc.decimal_cache_stats().size, 0u);
+    }
+
+    TEST(DecimalModeTest, RoundingModes) {
+        Calculator calc;
+        calc.set_variable("x", 0.125);
+        calc.set_variable("y", -0.125);
+        const struct {
+            RoundingMode mode;
+            const char* positive;
+            const char* negative;
+        } cases[] = {
+            {RoundingMode::HALF_EVEN, "0.12", "-0.12"},
+            {RoundingMode::HALF_UP, "0.13", "-0.13"},
+            {RoundingMode::DOWN, "0.12", "-0.12"},
+            {RoundingMode::FLOOR, "0.12", "-0.13"},
+            {RoundingMode::CEILING, "0.13", "-0.12"},
+        };
+        for (const auto& c : cases) {
+            calc.set_decimal_options({2, c.mode});
+            EXPECT_EQ(decimal(calc, "x * 1"), c.positive);
+            EXPECT_EQ(decimal(calc, "y * 1"), c.negative);
+            // 乘除结果同样按模式舍入：0.25 * 0.5 = 0.125
+            EXPECT_EQ(decimal(calc, "0.25 * 0.5"), c.positive);
+            EXPECT_EQ(decimal(calc, "(0 - 0.25) / 2"), c.negative);
+        }
+        calc.set_decimal_options({0, RoundingMode::HALF_EVEN});
+        EXPECT_EQ(decimal(calc, "5 / 2"), "2");
+        EXPECT_EQ(decimal(calc, "7 / 2"), "4");
+        EXPECT_THROW(calc.set_decimal_options({kMaxDecimalScale + 1, RoundingMode::DOWN}), CalculationError);
+    }
+
+    TEST(DecimalModeTest, WidePathsAndOverflow) {
+        Calculator calc;
+        calc.set_decimal_options({18, RoundingMode::HALF_EVEN});
+        // 乘积和被除数超出 128 位，走 256 位慢路径
+        EXPECT_EQ(decimal(calc, "123456789012345 * 1000000"), "123456789012345000000.000000000000000000");
+        EXPECT_EQ(decimal(calc, "1000000000000000000 / 3"), "333333333333333333.333333333333333333");
+        EXPECT_EQ(decimal(calc, "1.5 * 1.5"), "2.250000000000000000");
+        try {
+            calc.evaluate_decimal("100000000000000000000 * 100000000000000000000");
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_STREQ(e.what(), "Numeric overflow");
+            EXPECT_EQ(e.get_position(), 22u);
+        }
+        EXPECT_THROW(calc.evaluate_decimal("1e300"), CalculationError);
+        EXPECT_THROW(calc.evaluate_decimal("1 / (2 - 2)"), CalculationError);
+    }
+
+    TEST(DecimalModeTest, ParseAndFormat) {
+        DecimalArithmetic arithmetic({4, RoundingMode::HALF_EVEN});
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.parse("-1.25e3")).to_string(), "-1250.0000");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.parse("+.5")).to_string(), "0.5000");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.parse("123.456789")).to_string(), "123.4568");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.parse("1e-40")).to_string(), "0.0000");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.from_double(1e20)).to_string(), "100000000000000000000.0000");
+        EXPECT_THROW(arithmetic.parse("1.2.3"), CalculationError);
+        EXPECT_THROW(arithmetic.parse("e5"), CalculationError);
+        // 与逐位长除法的慢路径交叉检查快路径
+        const Int128 big = arithmetic.parse("12345678901234.5678");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.mul(big, arithmetic.parse("0.0001"))).to_string(), "1234567890.1235");
+        EXPECT_EQ(arithmetic.to_decimal(arithmetic.div(big, arithmetic.parse("-7"))).to_string(), "-1763668414462.0811");
+    }
+
+#endif // EXPRCALC_HAS_INT128
+
+} // namespace
\ No newline at end of file
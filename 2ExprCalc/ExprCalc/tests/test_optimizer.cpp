@@ -0,0 +1,190 @@
+#include "../src/optimizer.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include "../src/expr_generator.h"
+#include "../src/expression_dag.h"
+#include "../src/jit.h"
+#include "front_end_support.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace exprcalc;
+    using namespace exprcalc::test;
+
+    TEST(OptimizerTest, FoldsConstantSubtrees) {
+        Bytecode bytecode = compile_rpn("(2 + 3) * 4 * x");
+        OptimizationStats stats = BytecodeOptimizer().optimize(bytecode);
+        EXPECT_EQ(stats.nodes_before, 7u);
+        EXPECT_EQ(stats.nodes_after, 3u);
+        EXPECT_EQ(stats.removed(), 4u);
+        ASSERT_EQ(bytecode.constants.size(), 1u);
+        EXPECT_DOUBLE_EQ(bytecode.constants[0], 20.0);
+        EXPECT_EQ(bytecode.max_stack, 2u);
+        double slots[] = {1.5};
+        EXPECT_DOUBLE_EQ(Evaluator::execute(bytecode, slots), 30.0);
+    }
+
+    TEST(OptimizerTest, DoesNotReassociate) {
+        // x * 5 * 4 即 (x * 5) * 4，重新结合会改变舍入，不做折叠
+        Bytecode bytecode = compile_rpn("x * 5 * 4");
+        EXPECT_EQ(BytecodeOptimizer().optimize(bytecode).removed(), 0u);
+    }
+
+    TEST(OptimizerTest, SafeIdentities) {
+        for (const char* expression : {"x * 1", "1 * x", "x / 1", "x - 0", "x * (3 - 2)", "(2 - 1) * x / (4 / 4) - (1 - 1)"}) {
+            Bytecode bytecode = compile_rpn(expression);
+            BytecodeOptimizer().optimize(bytecode);
+            EXPECT_EQ(bytecode.code.size(), 1u) << expression;
+            EXPECT_EQ(bytecode.code[0].op, OpCode::LOAD_VAR) << expression;
+        }
+        // 这些在默认设置下不能化简
+        for (const char* expression : {"x + 0", "0 + x", "x * 0", "0 * x", "0 - x", "1 / x"}) {
+            Bytecode bytecode = compile_rpn(expression);
+            EXPECT_EQ(BytecodeOptimizer().optimize(bytecode).removed(), 0u) << expression;
+        }
+    }
+
+    TEST(OptimizerTest, UnsafeIdentitiesBehindFlag) {
+        OptimizerOptions options;
+        options.unsafe_identities = true;
+        Bytecode bytecode = compile_rpn("x + 0");
+        BytecodeOptimizer(options).optimize(bytecode);
+        EXPECT_EQ(bytecode.code.size(), 1u);
+
+        bytecode = compile_rpn("(x + y) * 0 + z");
+        BytecodeOptimizer(options).optimize(bytecode);
+        ASSERT_EQ(bytecode.variables.size(), 1u); // x、y 不再被引用
+        EXPECT_EQ(bytecode.variables[0], "z");
+        EXPECT_EQ(bytecode.code.size(), 1u);
+
+        // 含除法的一侧不能被乘 0 消掉，否则会丢失除零错误
+        bytecode = compile_rpn("x / y * 0");
+        EXPECT_EQ(BytecodeOptimizer(options).optimize(bytecode).removed(), 0u);
+    }
+
+    TEST(OptimizerTest, KeepsDivisionByZero) {
+        Calculator calc;
+        try {
+            calc.evaluate("1 + 2 / (3 - 3)");
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_STREQ(e.what(), "Division by zero");
+            EXPECT_EQ(e.get_position(), 6);
+        }
+    }
+
+    TEST(OptimizerTest, MatchesUnoptimizedResults) {
+        GeneratorOptions generator_options;
+        generator_options.seed = 11;
+        generator_options.terms = 12;
+        generator_options.variable_density = 0.3;
+        ExpressionGenerator generator(generator_options);
+        std::map<std::string, double> bindings;
+        for (size_t i = 0; i < generator.variable_names().size(); ++i) {
+            bindings[generator.variable_names()[i]] = generator.variable_values()[i];
+        }
+
+        size_t removed = 0;
+        for (int i = 0; i < 500; ++i) {
+            std::string expression = generator.next();
+            Bytecode plain = compile_rpn(expression);
+            Bytecode optimized = plain;
+            removed += BytecodeOptimizer().optimize(optimized).removed();
+            std::vector<double> plain_slots, optimized_slots;
+            for (const auto& name : plain.variables) plain_slots.push_back(bindings[name]);
+            for (const auto& name : optimized.variables) optimized_slots.push_back(bindings[name]);
+            EXPECT_EQ(Evaluator::execute(plain, plain_slots.data()),
+                      Evaluator::execute(optimized, optimized_slots.data())) << expression;
+        }
+        EXPECT_GT(removed, 0u);
+    }
+
+    TEST(OptimizerTest, CalculatorOptions) {
+        Calculator calc;
+        calc.set_variable("x", -0.0);
+        EXPECT_TRUE(std::signbit(calc.evaluate("x + 0")) == false);
+        OptimizerOptions options;
+        options.unsafe_identities = true;
+        calc.set_optimizer_options(options);
+        EXPECT_TRUE(std::signbit(calc.evaluate("x + 0"))); // 化简后直接返回 x，保留了 -0
+        EXPECT_EQ(calc.compile("2 * 3 + x").bytecode().code.size(), 3u);
+    }
+
+    TEST(OptimizerTest, CommonSubexpressions) {
+        Bytecode bytecode = compile_rpn("(a + b) * (a + b) / (c * (b + a))");
+        EXPECT_EQ(ExpressionDag(bytecode).size(), 7u); // a b + * c * /
+        EXPECT_EQ(ExpressionDag(bytecode).shared_count(), 1u);
+
+        OptimizationStats stats = BytecodeOptimizer().optimize(bytecode);
+        EXPECT_EQ(stats.nodes_before, 13u);
+        EXPECT_EQ(stats.nodes_after, 7u);
+        EXPECT_EQ(stats.temporaries, 1u);
+        EXPECT_EQ(bytecode.temp_count, 1u);
+        size_t additions = 0;
+        for (const auto& instruction : bytecode.code) {
+            if (instruction.op == OpCode::ADD) ++additions;
+        }
+        EXPECT_EQ(additions, 1u);
+
+        double slots[] = {1.0, 2.0, 4.0};
+        EXPECT_DOUBLE_EQ(Evaluator::execute(bytecode, slots), 9.0 / 12.0);
+    }
+
+    TEST(OptimizerTest, SharedSubexpressionErrorsKeepFirstPosition) {
+        Calculator calc;
+        calc.set_variable("x", 1.0);
+        calc.set_variable("y", 2.0);
+        auto compiled = calc.compile("x / (y - y) + x / (y - y)");
+        EXPECT_EQ(compiled.bytecode().temp_count, 1u);
+        try {
+            calc.evaluate(compiled);
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_EQ(e.get_position(), 2);
+        }
+    }
+
+    TEST(OptimizerTest, AllBackendsAgreeWithTemporaries) {
+        const char* expression = "(a * b - c) / (a * b + c) + (a * b - c) * (c + a * b) - a * b";
+        Calculator calc;
+        auto compiled = calc.compile(expression);
+        ASSERT_GT(compiled.bytecode().temp_count, 0u);
+
+        std::vector<double> a, b, c, out(1000);
+        for (int i = 0; i < 1000; ++i) {
+            a.push_back(i * 0.25 - 40);
+            b.push_back(3.0 - i % 7);
+            c.push_back(0.1 + i % 11);
+        }
+        compiled.evaluate_batch({{"a", a}, {"b", b}, {"c", c}}, out);
+
+        auto jit = JitFunction::compile(compiled.bytecode());
+        Bytecode plain = compile_rpn(expression);
+        for (size_t i = 0; i < out.size(); ++i) {
+            double slots[] = {a[i], b[i], c[i]};
+            double expected = Evaluator::execute(plain, slots);
+            EXPECT_EQ(Evaluator::execute(compiled.bytecode(), slots), expected);
+            EXPECT_EQ(out[i], expected);
+            if (jit) {
+                EXPECT_EQ(jit->evaluate(slots), expected);
+            }
+        }
+    }
+
+    TEST(OptimizerTest, LongChainsDoNotRecurse) {
+        std::string expression = "x";
+        for (int i = 0; i < 100000; ++i) expression += " + x * y";
+        Bytecode bytecode = compile_rpn(expression);
+        OptimizationStats stats = BytecodeOptimizer().optimize(bytecode);
+        EXPECT_EQ(stats.temporaries, 1u);
+        double slots[] = {1.0, 2.0};
+        EXPECT_DOUBLE_EQ(Evaluator::execute(bytecode, slots), 200001.0);
+    }
+
+} // namespace
\ No newline at end of file
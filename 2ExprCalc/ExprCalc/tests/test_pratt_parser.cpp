@@ -0,0 +1,109 @@
+#include "../src/pratt_parser.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include "../src/expr_generator.h"
+#include "../src/jit.h"
+#include "front_end_support.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace exprcalc;
+    using namespace exprcalc::test;
+
+    TEST(PrattParserTest, MatchesShuntingYard) {
+        GeneratorOptions options;
+        options.seed = 9;
+        options.terms = 24;
+        options.paren_density = 0.5;
+        options.max_depth = 6;
+        ExpressionGenerator generator(options);
+        for (int i = 0; i < 300; ++i) {
+            std::string expression = generator.next();
+            SCOPED_TRACE(expression);
+            expect_same_bytecode(PrattParser(expression).parse(), compile_rpn(expression));
+        }
+    }
+
+    TEST(PrattParserTest, SameErrorsAsShuntingYard) {
+        expect_same_errors_as_rpn([](const std::string& expression) { PrattParser(expression).parse(); });
+        // 前缀负号之外的运算符不能出现在操作数位置
+        EXPECT_EQ(error_of([] { PrattParser("* 2").parse(); }), error_of([] { compile_rpn("* 2"); }));
+    }
+
+    TEST(PrattParserTest, PrefixMinus) {
+        Calculator calc;
+        calc.set_front_end(FrontEnd::PRATT);
+        calc.set_variable("x", 5.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("-3 + 4"), 1.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("2 * -x"), -10.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("-(1 + 2) * 3"), -9.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("- -x"), 5.0);
+        EXPECT_DOUBLE_EQ(calc.evaluate("1 - -x / 2"), 3.5);
+        EXPECT_TRUE(std::signbit(calc.evaluate("-(x - x)")));
+        // 常量取反在编译期折叠
+        EXPECT_EQ(calc.compile("-2 * x").bytecode().code.size(), 3u);
+        // 其他前端仍不接受前缀运算符
+        calc.set_front_end(FrontEnd::SHUNTING_YARD);
+        EXPECT_THROW(calc.evaluate("-3 + 4"), CalculationError);
+    }
+
+    TEST(PrattParserTest, NegationInAllBackends) {
+        const std::string expression = "-a * (b - -c) + -(a / b)";
+        Bytecode bytecode = PrattParser(expression).parse();
+        std::vector<double> a, b, c, out(300);
+        for (int i = 0; i < 300; ++i) {
+            a.push_back(i - 150.0);
+            b.push_back(0.5 + i % 9);
+            c.push_back(i % 4 == 0 ? -0.0 : i * 0.1);
+        }
+        BatchEvaluator(bytecode, {{"a", a}, {"b", b}, {"c", c}}).evaluate(out);
+        auto jit = JitFunction::compile(bytecode);
+        for (size_t i = 0; i < out.size(); ++i) {
+            double slots[] = {a[i], b[i], c[i]};
+            double expected = -a[i] * (b[i] - -c[i]) + -(a[i] / b[i]);
+            EXPECT_EQ(Evaluator::execute(bytecode, slots), expected);
+            EXPECT_EQ(out[i], expected);
+            if (jit) {
+                EXPECT_EQ(jit->evaluate(slots), expected);
+            }
+        }
+
+        // 取反只翻转符号位，NaN 的符号也要与解释器一致
+        Bytecode negate = PrattParser("-a").parse();
+        double nan_slot[] = {std::nan("")};
+        EXPECT_TRUE(std::signbit(Evaluator::execute(negate, nan_slot)));
+        if (auto negate_jit = JitFunction::compile(negate)) {
+            EXPECT_TRUE(std::signbit(negate_jit->evaluate(nan_slot)));
+        }
+    }
+
+    TEST(PrattParserTest, NestingLimit) {
+        auto nested = [](size_t depth) {
+            return std::string(depth, '(') + "1" + std::string(depth, ')');
+        };
+        EXPECT_EQ(PrattParser(nested(1000)).parse().code.size(), 1u);
+        try {
+            PrattParser(nested(PrattParser::kMaxNesting + 10)).parse();
+            FAIL() << "expected CalculationError";
+        } catch (const CalculationError& e) {
+            EXPECT_STREQ(e.what(), "Expression nested too deeply");
+        }
+    }
+
+    TEST(PrattParserTest, LexerPullsOneTokenAtATime) {
+        Lexer lexer("a + 12");
+        EXPECT_EQ(lexer.next().type, TokenType::VARIABLE);
+        EXPECT_EQ(lexer.next().type, TokenType::OPERATOR);
+        Token number = lexer.next();
+        EXPECT_DOUBLE_EQ(number.number, 12.0);
+        Token end = lexer.next();
+        EXPECT_EQ(end.type, TokenType::END);
+        EXPECT_EQ(end.position, 6u);
+        EXPECT_EQ(lexer.next().type, TokenType::END);
+    }
+
+} // namespace
@@ -0,0 +1,95 @@
+#include "../src/simd_kernels.h"
+#include "../src/scan_kernels.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace exprcalc;
+
+    const SimdLevel kAllLevels[] = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+    TEST(SimdKernelsTest, MatchesScalarForAllLevels) {
+        for (SimdLevel level : kAllLevels) {
+            const KernelTable& kernels = kernels_for(level);
+            EXPECT_LE(kernels.level, detect_simd_level());
+            for (size_t n : {0, 1, 3, 7, 8, 9, 17, 31, 64}) {
+                std::vector<double> a(n), b(n), out(n);
+                for (size_t i = 0; i < n; ++i) {
+                    a[i] = 1.5 * static_cast<double>(i) - 4.0;
+                    b[i] = 0.25 * static_cast<double>(i) + 1.0;
+                }
+                kernels.add(a.data(), b.data(), out.data(), n);
+                for (size_t i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(out[i], a[i] + b[i]);
+                kernels.sub(a.data(), b.data(), out.data(), n);
+                for (size_t i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(out[i], a[i] - b[i]);
+                kernels.mul(a.data(), b.data(), out.data(), n);
+                for (size_t i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(out[i], a[i] * b[i]);
+                EXPECT_EQ(kernels.div(a.data(), b.data(), out.data(), n), n);
+                for (size_t i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(out[i], a[i] / b[i]);
+            }
+        }
+    }
+
+    TEST(SimdKernelsTest, DivisionReportsFirstZero) {
+        for (SimdLevel level : kAllLevels) {
+            const KernelTable& kernels = kernels_for(level);
+            for (size_t zero : {0, 5, 12, 20}) {
+                std::vector<double> a(21, 1.0), b(21, 2.0), out(21);
+                b[zero] = -0.0;
+                if (zero + 1 < b.size()) b[zero + 1] = 0.0;
+                EXPECT_EQ(kernels.div(a.data(), b.data(), out.data(), b.size()), zero)
+                    << simd_level_name(kernels.level);
+            }
+        }
+    }
+
+    TEST(SimdKernelsTest, BatchEvaluatorAtEveryLevel) {
+        const size_t rows = 1003;
+        std::vector<double> x(rows), y(rows), expected(rows), out(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            x[i] = static_cast<double>(i) * 0.5;
+            y[i] = static_cast<double>(i % 11) + 0.5;
+        }
+        Calculator calc;
+        auto compiled = calc.compile("(x - 3) * y / (y + 1) + x");
+        ColumnMap columns{{"x", x}, {"y", y}};
+        for (size_t i = 0; i < rows; ++i) {
+            expected[i] = compiled.evaluate({{"x", x[i]}, {"y", y[i]}});
+        }
+        for (SimdLevel level : kAllLevels) {
+            BatchEvaluator evaluator(compiled.bytecode(), columns);
+            evaluator.set_simd_level(level);
+            evaluator.evaluate(out);
+            for (size_t i = 0; i < rows; ++i) {
+                ASSERT_DOUBLE_EQ(out[i], expected[i]) << simd_level_name(evaluator.simd_level()) << " row " << i;
+            }
+        }
+    }
+
+    TEST(SimdKernelsTest, ClassifyMatchesCtype) {
+        // 所有 256 个字节值，放在块内不同偏移上，并覆盖不足一个块的尾部
+        std::string bytes;
+        for (int c = 0; c < 256; ++c) bytes.push_back(static_cast<char>(c));
+        for (SimdLevel level : kAllLevels) {
+            ClassifyKernel classify = classify_kernel_for(level);
+            for (size_t start = 0; start + 1 < bytes.size(); start += 13) {
+                const size_t n = std::min(kScanBlock, bytes.size() - start);
+                const CharMasks masks = classify(bytes.data() + start, n);
+                for (size_t i = 0; i < kScanBlock; ++i) {
+                    const int c = i < n ? static_cast<unsigned char>(bytes[start + i]) : -1;
+                    const bool in = i < n;
+                    EXPECT_EQ((masks.space >> i) & 1, in && c < 128 && std::isspace(c) ? 1u : 0u) << c;
+                    EXPECT_EQ((masks.number >> i) & 1, in && (std::isdigit(c) || c == '.' || c == '_') ? 1u : 0u) << c;
+                    EXPECT_EQ((masks.ident >> i) & 1, in && c < 128 && std::isalnum(c) ? 1u : 0u) << c;
+                }
+            }
+        }
+    }
+
+} // anonymous namespace
\ No newline at end of file
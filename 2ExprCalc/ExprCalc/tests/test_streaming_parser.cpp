@@ -0,0 +1,70 @@
+#include "../src/streaming_parser.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include "../src/expr_generator.h"
+#include "front_end_support.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+    using namespace exprcalc;
+    using namespace exprcalc::test;
+
+    TEST(StreamingParserTest, MatchesShuntingYard) {
+        GeneratorOptions options;
+        options.seed = 21;
+        options.terms = 32;
+        options.paren_density = 0.5;
+        options.max_depth = 8;
+        ExpressionGenerator generator(options);
+        for (int i = 0; i < 300; ++i) {
+            std::string expression = generator.next();
+            SCOPED_TRACE(expression);
+            expect_same_bytecode(StreamingParser(expression).parse(), compile_rpn(expression));
+        }
+    }
+
+    TEST(StreamingParserTest, SameErrorsAsShuntingYard) {
+        expect_same_errors_as_rpn([](const std::string& expression) { StreamingParser(expression).parse(); });
+        // 与调度场一样不接受前缀负号
+        EXPECT_EQ(error_of([] { StreamingParser("-1").parse(); }), error_of([] { compile_rpn("-1"); }));
+    }
+
+    TEST(StreamingParserTest, NoNestingLimit) {
+        const size_t depth = 100000;
+        std::string nested;
+        for (size_t i = 0; i < depth; ++i) nested += "1 + (";
+        nested += "1" + std::string(depth, ')');
+        Bytecode bytecode = StreamingParser(nested).parse();
+        EXPECT_EQ(bytecode.code.size(), 2 * depth + 1);
+        EXPECT_EQ(bytecode.max_stack, depth + 1);
+
+        Calculator calc;
+        EXPECT_DOUBLE_EQ(calc.evaluate(nested), depth + 1.0);
+        EXPECT_THROW(PrattParser(nested).parse(), CalculationError);
+    }
+
+    TEST(StreamingParserTest, MegabyteExpressionThroughCalculator) {
+        GeneratorOptions options;
+        options.seed = 5;
+        options.terms = 200000;
+        options.variables = 4;
+        options.paren_density = 0.2;
+        ExpressionGenerator generator(options);
+        const std::string expression = generator.next();
+        ASSERT_GT(expression.size(), 1u << 20);
+
+        Calculator streaming;
+        Calculator rpn;
+        rpn.set_front_end(FrontEnd::SHUNTING_YARD);
+        for (Calculator* calc : {&streaming, &rpn}) {
+            calc->set_cache_capacity(0);
+            for (size_t v = 0; v < generator.variable_names().size(); ++v) {
+                calc->set_variable(generator.variable_names()[v], generator.variable_values()[v]);
+            }
+        }
+        EXPECT_EQ(streaming.evaluate(expression), rpn.evaluate(expression));
+    }
+
+} // namespace
\ No newline at end of file
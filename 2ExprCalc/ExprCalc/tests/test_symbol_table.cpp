@@ -0,0 +1,57 @@
+#include "../src/symbol_table.h"
+#include "../src/calculator.h"
+#include "../src/error.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+    using namespace exprcalc;
+
+    TEST(SymbolTableTest, InternAssignsDenseSlots) {
+        SymbolTable symbols;
+        VariableRef x = symbols.intern("x");
+        VariableRef y = symbols.intern("y");
+        EXPECT_EQ(x.slot(), 0);
+        EXPECT_EQ(y.slot(), 1);
+        EXPECT_EQ(symbols.intern("x"), x);
+        EXPECT_EQ(symbols.size(), 2);
+        EXPECT_EQ(symbols.name(y), "y");
+
+        EXPECT_FALSE(symbols.is_defined(x));
+        EXPECT_FALSE(symbols.has_variable("x"));
+        EXPECT_THROW(symbols.get(x), CalculationError);
+
+        symbols.set(x, 3.5);
+        EXPECT_DOUBLE_EQ(symbols.get(x), 3.5);
+        EXPECT_DOUBLE_EQ(symbols.get_variable("x"), 3.5);
+        symbols.set_variable("y", -1.0);
+        EXPECT_DOUBLE_EQ(symbols.get(y), -1.0);
+        EXPECT_FALSE(symbols.find("z").has_value());
+    }
+
+    TEST(SymbolTableTest, CopyGetsNewIdentity) {
+        SymbolTable symbols;
+        symbols.set_variable("x", 1.0);
+        SymbolTable copy = symbols;
+        EXPECT_NE(copy.id(), symbols.id());
+        EXPECT_DOUBLE_EQ(copy.get_variable("x"), 1.0);
+    }
+
+    TEST(SymbolTableTest, CompiledExpressionUsesBoundSlots) {
+        Calculator calc;
+        VariableRef rate = calc.variable("rate");
+        auto compiled = calc.compile("principal * rate");
+        calc.set_variable("principal", 200.0);
+        for (int i = 1; i <= 3; ++i) {
+            calc.set_variable(rate, 0.5 * i);
+            EXPECT_DOUBLE_EQ(calc.evaluate(compiled), 100.0 * i);
+        }
+
+        // 对未绑定的表求值时退回到按名字查找
+        SymbolTable other;
+        other.set_variable("rate", 2.0);
+        other.set_variable("principal", 3.0);
+        EXPECT_DOUBLE_EQ(compiled.evaluate(other), 6.0);
+    }
+
+} // anonymous namespace
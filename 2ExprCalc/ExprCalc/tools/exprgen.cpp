@@ -0,0 +1,110 @@
+#include "../src/expr_generator.h"
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+    void print_usage() {
+        std::cerr << "Usage: ExprGen [options]\n"
+                  << "  --count N         number of expressions (default 1000)\n"
+                  << "  --seed S          random seed (default 1)\n"
+                  << "  --terms N         operands per expression (default 16)\n"
+                  << "  --depth N         maximum parenthesis depth (default 4)\n"
+                  << "  --parens P        parenthesis density 0..1 (default 0.2)\n"
+                  << "  --ops A,B,C,D     weights of + - * / (default 1,1,1,1)\n"
+                  << "  --variables N     variable set v0..v{N-1} (default 4)\n"
+                  << "  --var-density P   probability an operand is a variable (default 0.5)\n"
+                  << "  --bindings FILE   also write 'set vN = value' lines to FILE\n"
+                  << "  --output FILE     write expressions to FILE instead of stdout\n";
+    }
+
+    std::array<unsigned, 4> parse_weights(const std::string& text) {
+        std::array<unsigned, 4> weights{};
+        size_t start = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            size_t comma = text.find(',', start);
+            if ((comma == std::string::npos) != (i == weights.size() - 1)) {
+                throw std::runtime_error("--ops expects four comma-separated weights");
+            }
+            weights[i] = static_cast<unsigned>(std::stoul(text.substr(start, comma - start)));
+            start = comma + 1;
+        }
+        return weights;
+    }
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    exprcalc::GeneratorOptions options;
+    unsigned long long count = 1000;
+    std::string bindings_path;
+    std::string output_path;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                print_usage();
+                return 0;
+            }
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + std::string(arg));
+            std::string value = argv[++i];
+            if (arg == "--count") count = std::stoull(value);
+            else if (arg == "--seed") options.seed = std::stoull(value);
+            else if (arg == "--terms") options.terms = std::stoul(value);
+            else if (arg == "--depth") options.max_depth = std::stoul(value);
+            else if (arg == "--parens") options.paren_density = std::stod(value);
+            else if (arg == "--ops") options.operator_weights = parse_weights(value);
+            else if (arg == "--variables") options.variables = std::stoul(value);
+            else if (arg == "--var-density") options.variable_density = std::stod(value);
+            else if (arg == "--bindings") bindings_path = value;
+            else if (arg == "--output") output_path = value;
+            else throw std::runtime_error("Unknown option " + std::string(arg));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        print_usage();
+        return 1;
+    }
+
+    exprcalc::ExpressionGenerator generator(options);
+    if (!bindings_path.empty()) {
+        std::ofstream bindings(bindings_path);
+        if (!bindings) {
+            std::cerr << "Error: cannot open " << bindings_path << '\n';
+            return 1;
+        }
+        generator.write_bindings(bindings);
+    }
+
+    std::FILE* out = stdout;
+    if (!output_path.empty()) {
+        out = std::fopen(output_path.c_str(), "wb");
+        if (out == nullptr) {
+            std::cerr << "Error: cannot open " << output_path << '\n';
+            return 1;
+        }
+    }
+
+    // 攒够一大块再写，输出 GB 级数据时不让 I/O 成为瓶颈
+    constexpr size_t kFlushSize = 1 << 20;
+    std::string buffer;
+    buffer.reserve(kFlushSize + 4096);
+    for (unsigned long long n = 0; n < count; ++n) {
+        generator.append_next(buffer);
+        buffer += '\n';
+        if (buffer.size() >= kFlushSize) {
+            std::fwrite(buffer.data(), 1, buffer.size(), out);
+            buffer.clear();
+        }
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), out);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}